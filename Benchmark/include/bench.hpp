@@ -0,0 +1,74 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Contains Suite class - minimal benchmark harness used by CLL-bench.
+// Every benchmark is a function that executes n iterations of measured code.
+// It can also have a function that prepares every batch (e.g. creates interpreter) - it is not measured.
+// Number of iterations is calibrated, so that one batch takes about given time divided by number of repetitions,
+// then batches are repeated and median and minimal time per iteration are reported.
+// Benchmarks with few iterations per batch are repeated more, so that at least 'samples' iterations are measured.
+//
+// Results can be saved as JSON and compared against baseline saved earlier - every benchmark
+// that is slower than its baseline by more than threshold is reported as regression.
+// Every suite runs calibration benchmark that does not use CLL at all - its batch is measured right before every batch of other benchmarks.
+// Benchmarks are compared by median ratio of their batch time to time of that calibration batch, so that speed of machine
+// (and its load, which can change during the run) mostly cancels out. Baseline made on very different machine should still be made again.
+
+namespace bench
+{
+	const std::string calibration = "calibration"; // Name of benchmark that results are normalized by
+
+	struct result
+	{
+		std::string name;
+		size_t iterations; // Iterations of one batch
+		double median; // Median time of iteration in nanoseconds
+		double min; // Minimal time of iteration in nanoseconds
+		double relative; // Median ratio of time of iteration to time of calibration iteration measured right before it
+	};
+
+	class Suite
+	{
+		struct benchmark
+		{
+			std::string name;
+			std::function<void(size_t)> run;
+			std::function<void()> prepare; // Called before every batch - empty if benchmark needs no preparation
+		};
+
+		std::vector<benchmark> benchmarks;
+		benchmark calibrator;
+
+		size_t iterations(const benchmark& b, const double& batch); // Returns number of iterations that take about batch nanoseconds
+
+	public:
+
+		std::chrono::milliseconds time; // Time spent on every benchmark
+		size_t repetitions; // Number of measured batches
+		size_t samples; // Minimal number of measured iterations - benchmarks with fewer iterations per batch get more batches
+		std::string filter; // Only benchmarks which names contain it are run
+		std::vector<std::string> names; // If it is not empty, only benchmarks with these names are run (e.g. to run regressed ones again)
+
+		Suite(); // Creates suite with calibration benchmark
+
+		inline void add(const std::string& n, const std::function<void(size_t)>& f, const std::function<void()>& p = nullptr) { benchmarks.push_back({ n, f, p }); };
+
+		std::vector<result> run(); // Runs benchmarks and reports progress on std::cerr - calibration is always the first result
+	};
+
+	std::vector<result> merge(const std::vector<std::vector<result>>& runs); // Returns medians of results of the same benchmarks from several runs
+	std::string json(const std::vector<result>& r); // Returns results as JSON document
+	bool load(const std::string& path, std::vector<result>& r, std::string& error); // Reads results from JSON document written by json(), returns false and sets error if document is not in its format
+
+	// Appends table of deltas between baseline and results to report and names of benchmarks that exceeded threshold to regressed
+	// Threshold parameter stands for allowed slowdown in percents, returns false if any benchmark exceeds it or calibration is missing
+	bool compare(const std::vector<result>& baseline, const std::vector<result>& r, const double& threshold, std::string& report, std::vector<std::string>& regressed);
+
+	void keep(const std::string& s); // Prevents compiler from optimizing away result of measured code
+}
\ No newline at end of file
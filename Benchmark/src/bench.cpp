@@ -0,0 +1,298 @@
+#include "bench.hpp"
+
+// Author: Bartosz Niciak
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+namespace bench
+{
+	static volatile size_t sink = 0;
+
+	void keep(const std::string& s)
+	{
+		sink = sink + s.size();
+	}
+
+	// Returns time of n iterations in nanoseconds - preparation of batch is not included
+	static double measure(const std::function<void(size_t)>& f, const std::function<void()>& p, const size_t& n)
+	{
+		if (p) p();
+
+		std::chrono::steady_clock::time_point begin = std::chrono::steady_clock::now();
+		f(n);
+		return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin).count();
+	}
+
+	// Calibration formats numbers into strings - it allocates and branches a lot, like interpreter does
+	Suite::Suite() : time(500), repetitions(5), samples(15)
+	{
+		calibrator.name = calibration;
+		calibrator.run = [](size_t n)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				std::string s;
+				for (size_t ii = 0; ii < 64; ++ii) s += std::to_string(ii * i) + ",";
+
+				keep(s);
+			}
+		};
+	}
+
+	// Iterations are doubled until they take a tenth of batch, then scaled up
+	size_t Suite::iterations(const benchmark& b, const double& batch)
+	{
+		size_t n = 1;
+		double elapsed = measure(b.run, b.prepare, n);
+
+		while (elapsed < batch / 10 && n < (size_t(1) << 40))
+		{
+			n *= 2;
+			elapsed = measure(b.run, b.prepare, n);
+		}
+
+		return std::max(size_t(1), size_t(double(n) * batch / std::max(elapsed, 1.0)));
+	}
+
+	std::vector<result> Suite::run()
+	{
+		std::vector<result> results;
+		double batch = std::chrono::duration<double, std::nano>(time).count() / std::max(repetitions, size_t(1));
+
+		// Calibration is measured between batches of other benchmarks, so that it sees machine in the same state as they do
+		size_t c = iterations(calibrator, batch / 4);
+		std::vector<double> calibrations;
+
+		for (size_t i = 0; i < benchmarks.size(); ++i)
+		{
+			if (benchmarks[i].name.find(filter) == std::string::npos) continue;
+			if (!names.empty() && std::find(names.begin(), names.end(), benchmarks[i].name) == names.end()) continue;
+
+			size_t n = iterations(benchmarks[i], batch);
+			size_t batches = std::max(std::max(repetitions, size_t(1)), (samples + n - 1) / n);
+
+			// MEASUREMENT
+			std::vector<double> times, ratios;
+
+			// Every batch is compared with average of calibration batches before and after it, so that drift of machine speed cancels out
+			double before = measure(calibrator.run, calibrator.prepare, c) / double(c);
+
+			for (size_t ii = 0; ii < batches; ++ii)
+			{
+				times.emplace_back(measure(benchmarks[i].run, benchmarks[i].prepare, n) / double(n));
+				double after = measure(calibrator.run, calibrator.prepare, c) / double(c);
+
+				ratios.emplace_back(times.back() * 2 / (before + after));
+				calibrations.emplace_back(after);
+				before = after;
+			}
+
+			std::sort(times.begin(), times.end());
+			std::sort(ratios.begin(), ratios.end());
+			results.push_back({ benchmarks[i].name, n, times[times.size() / 2], times[0], ratios[ratios.size() / 2] });
+
+			std::cerr << benchmarks[i].name << ": " << results.back().median << " ns\n";
+		}
+
+		while (calibrations.size() < std::max(repetitions, size_t(1))) calibrations.emplace_back(measure(calibrator.run, calibrator.prepare, c) / double(c));
+
+		std::sort(calibrations.begin(), calibrations.end());
+		results.insert(results.begin(), { calibration, c, calibrations[calibrations.size() / 2], calibrations[0], 1.0 });
+
+		std::cerr << calibration << ": " << results.front().median << " ns\n";
+
+		return results;
+	}
+
+	std::vector<result> merge(const std::vector<std::vector<result>>& runs)
+	{
+		std::vector<result> merged;
+		if (runs.empty()) return merged;
+
+		for (size_t i = 0; i < runs[0].size(); ++i)
+		{
+			std::vector<double> medians, ratios;
+			result m = runs[0][i];
+
+			for (size_t ii = 0; ii < runs.size(); ++ii)
+			{
+				if (i >= runs[ii].size() || runs[ii][i].name != m.name) continue;
+
+				medians.emplace_back(runs[ii][i].median);
+				ratios.emplace_back(runs[ii][i].relative);
+				m.min = std::min(m.min, runs[ii][i].min);
+			}
+
+			std::sort(medians.begin(), medians.end());
+			std::sort(ratios.begin(), ratios.end());
+
+			m.median = medians[medians.size() / 2];
+			m.relative = ratios[ratios.size() / 2];
+			merged.emplace_back(m);
+		}
+
+		return merged;
+	}
+
+	std::string json(const std::vector<result>& r)
+	{
+		std::string out = "{\n\t\"benchmarks\": [\n";
+		char buff[64];
+
+		for (size_t i = 0; i < r.size(); ++i)
+		{
+			out += "\t\t{ \"name\": \"" + r[i].name + "\", \"iterations\": " + std::to_string(r[i].iterations);
+
+			std::snprintf(buff, sizeof(buff), "%.2f", r[i].median);
+			out += ", \"median_ns\": " + std::string(buff);
+
+			std::snprintf(buff, sizeof(buff), "%.2f", r[i].min);
+			out += ", \"min_ns\": " + std::string(buff);
+
+			std::snprintf(buff, sizeof(buff), "%.6f", r[i].relative);
+			out += ", \"relative\": " + std::string(buff) + " }";
+
+			if (i + 1 < r.size()) out += ",";
+			out += "\n";
+		}
+
+		out += "\t]\n}\n";
+
+		return out;
+	}
+
+	// Skips text at position of line, returns false if line does not contain it there
+	static bool expect(const std::string& l, size_t& pos, const std::string& text)
+	{
+		if (l.compare(pos, text.length(), text) != 0) return false;
+
+		pos += text.length();
+		return true;
+	}
+
+	// Reads number at position of line, returns false if there is no number
+	static bool number(const std::string& l, size_t& pos, double& val)
+	{
+		const char* begin = l.c_str() + pos;
+		char* end = nullptr;
+
+		val = std::strtod(begin, &end);
+		if (end == begin) return false;
+
+		pos += end - begin;
+		return true;
+	}
+
+	// Reads line of one benchmark, e.g. '{ "name": "lexer/call", "iterations": 10, "median_ns": 2.50, "min_ns": 2.00, "relative": 0.800000 }'
+	static bool entry(const std::string& l, result& r, bool& last)
+	{
+		size_t pos = 0;
+		double iterations = 0;
+
+		if (!expect(l, pos, "\t\t{ \"name\": \"")) return false;
+
+		size_t end = l.find('"', pos);
+		if (end == std::string::npos || end == pos) return false;
+
+		r.name = l.substr(pos, end - pos);
+		pos = end;
+
+		if (!expect(l, pos, "\", \"iterations\": ") || !number(l, pos, iterations)) return false;
+		if (!expect(l, pos, ", \"median_ns\": ") || !number(l, pos, r.median)) return false;
+		if (!expect(l, pos, ", \"min_ns\": ") || !number(l, pos, r.min)) return false;
+		if (!expect(l, pos, ", \"relative\": ") || !number(l, pos, r.relative) || !expect(l, pos, " }")) return false;
+
+		r.iterations = size_t(iterations);
+		last = !expect(l, pos, ",");
+
+		return pos == l.length();
+	}
+
+	// Only exact format written by json() is accepted - every benchmark is written in its own line
+	bool load(const std::string& path, std::vector<result>& r, std::string& error)
+	{
+		std::ifstream file(path);
+
+		if (!file.good())
+		{
+			error = "File '" + path + "' could not be opened";
+			return false;
+		}
+
+		std::string l;
+		size_t line = 0;
+		bool last = false;
+
+		auto next = [&]() { ++line; return bool(std::getline(file, l)); };
+		auto fail = [&](const std::string& e) { error = "Line " + std::to_string(line) + " of '" + path + "': " + e; r.clear(); return false; };
+
+		if (!next() || l != "{") return fail("expected '{'");
+		if (!next() || l != "\t\"benchmarks\": [") return fail("expected '\"benchmarks\": ['");
+
+		while (next() && l != "\t]")
+		{
+			if (last) return fail("expected ']' after benchmark without comma");
+
+			result res;
+			if (!entry(l, res, last)) return fail("malformed benchmark '" + l + "'");
+
+			r.push_back(res);
+		}
+
+		if (l != "\t]") return fail("expected ']'");
+		if (!r.empty() && !last) return fail("comma after last benchmark");
+		if (!next() || l != "}") return fail("expected '}'");
+		if (next()) return fail("unexpected text after end of document");
+
+		return true;
+	}
+
+	// Ratios to calibration are compared - median times are only shown, because they depend on speed of machine
+	bool compare(const std::vector<result>& baseline, const std::vector<result>& r, const double& threshold, std::string& report, std::vector<std::string>& regressed)
+	{
+		std::map<std::string, result> base;
+		for (size_t i = 0; i < baseline.size(); ++i) base[baseline[i].name] = baseline[i];
+
+		if (base.find(calibration) == base.end() || r.empty() || r[0].name != calibration)
+		{
+			report += "Baseline or results have no '" + calibration + "' benchmark - baseline has to be made again\n";
+			return false;
+		}
+
+		bool passed = true;
+		char buff[160];
+
+		std::snprintf(buff, sizeof(buff), "%-32s %16s %16s %10s\n", "benchmark", "baseline [ns]", "current [ns]", "delta");
+		report += buff;
+
+		for (size_t i = 1; i < r.size(); ++i)
+		{
+			auto it = base.find(r[i].name);
+
+			if (it == base.end() || it->second.relative <= 0)
+			{
+				std::snprintf(buff, sizeof(buff), "%-32s %16s %16.2f %10s\n", r[i].name.c_str(), "-", r[i].median, "new");
+				report += buff;
+				continue;
+			}
+
+			double delta = (r[i].relative - it->second.relative) / it->second.relative * 100;
+
+			if (delta > threshold)
+			{
+				passed = false;
+				regressed.push_back(r[i].name);
+			}
+
+			std::snprintf(buff, sizeof(buff), "%-32s %16.2f %16.2f %+9.1f%%%s\n", r[i].name.c_str(), it->second.median, r[i].median, delta, (delta > threshold) ? "   REGRESSION" : "");
+			report += buff;
+		}
+
+		return passed;
+	}
+}
\ No newline at end of file
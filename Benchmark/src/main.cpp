@@ -0,0 +1,250 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// Author: Bartosz Niciak
+
+#include "bench.hpp"
+#include "CLL.hpp"
+
+// This main file runs benchmarks of CLL and prints their results as JSON.
+// Micro benchmarks measure single parts of interpreter (lexer, var arithmetic, arrays, function calls, file reading),
+// while macro benchmarks run prime number scripts from Examples directory at multiple sizes.
+//
+// Arguments:
+// --filter text   - runs only benchmarks which names contain text
+// --time ms       - time spent on every benchmark (500 by default)
+// --output path   - writes results to file instead of standard output (e.g. to make new baseline)
+// --runs n        - runs suite n times and reports medians of the runs (1 by default, 3 is recommended for baseline)
+// --baseline path - compares results with baseline and returns 1 if any benchmark is slower than threshold allows (times are normalized by calibration benchmark
+//                   and regressed benchmarks are run again to confirm regression)
+// --threshold %   - allowed slowdown in percents (15 by default)
+
+#ifndef CLL_SCRIPTS
+#define CLL_SCRIPTS "Examples/scripts"
+#endif
+
+// Adds benchmark that executes every line in fresh interpreter after setup lines
+// Interpreter is created and set up before batch, so only execution of line is measured
+void addScript(bench::Suite& suite, const std::string& name, const std::vector<std::string>& setup, const std::string& line)
+{
+	std::shared_ptr<std::unique_ptr<cll::Interpreter>> in = std::make_shared<std::unique_ptr<cll::Interpreter>>();
+
+	suite.add(name, [in, line](size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) (*in)->readLine(line);
+
+		bench::keep((*in)->getError());
+	},
+	[in, setup]()
+	{
+		*in = std::make_unique<cll::Interpreter>();
+		(*in)->readVector(setup);
+	});
+}
+
+// Adds benchmark that runs prime number script with given number of primes to find
+void addPrimes(bench::Suite& suite, const std::string& script, const size_t& primes)
+{
+	std::string path = std::string(CLL_SCRIPTS) + "/prime numbers/" + script + ".cll";
+
+	suite.add("primes/" + script + "/" + std::to_string(primes), [path, primes](size_t n)
+	{
+		for (size_t i = 0; i < n; ++i)
+		{
+			cll::Interpreter in;
+			in.setVar("primes", std::to_string(primes));
+
+			if (!in.readFile(path)) std::cerr << in.getError() << '\n';
+			bench::keep(in.getVar("start").getValue());
+		}
+	});
+}
+
+int main(int argc, char* argv[])
+{
+	std::ios_base::sync_with_stdio(false);
+
+	bench::Suite suite;
+	std::string output;
+	std::string baseline;
+	double threshold = 15;
+	size_t runs = 1;
+
+	for (int i = 1; i < argc; i += 2)
+	{
+		std::string arg(argv[i]);
+
+		if (i + 1 == argc)
+		{
+			std::cerr << "Argument '" << arg << "' has no value\n";
+			return 1;
+		}
+
+		if (arg == "--filter") suite.filter = argv[i + 1];
+		else if (arg == "--time") suite.time = std::chrono::milliseconds(std::stoll(argv[i + 1]));
+		else if (arg == "--output") output = argv[i + 1];
+		else if (arg == "--baseline") baseline = argv[i + 1];
+		else if (arg == "--threshold") threshold = std::stod(argv[i + 1]);
+		else if (arg == "--runs") runs = std::max(std::stoull(argv[i + 1]), 1ULL);
+		else
+		{
+			std::cerr << "Unknown argument '" << arg << "'\n";
+			return 1;
+		}
+	}
+
+	// LEXER
+	const std::string lines[][2] =
+	{
+		{ "lexer/assignment", "x = 10 + y * 2" },
+		{ "lexer/call", "cout fib(n - 1) + fib(n - 2) \" items\" endl" },
+		{ "lexer/array", "arr = [1, 2.5, \"three\", 'c', [4, 5]]" },
+		{ "lexer/loop", "for i = 0, i < size(vec), i += 1 // comment" }
+	};
+
+	for (const auto& l : lines)
+	{
+		std::string line = l[1];
+
+		suite.add(l[0], [line](size_t n)
+		{
+			for (size_t i = 0; i < n; ++i) bench::keep(cll::lexer(line).back().value);
+		});
+	}
+
+	// VAR ARITHMETIC
+	suite.add("var/int", [](size_t n)
+	{
+		cll::var a("12345"), b("678");
+		for (size_t i = 0; i < n; ++i) bench::keep((a * b + a - b).value);
+	});
+
+	suite.add("var/double", [](size_t n)
+	{
+		cll::var a("123.45"), b("6.78");
+		for (size_t i = 0; i < n; ++i) bench::keep((a * b + a / b).value);
+	});
+
+	suite.add("var/string", [](size_t n)
+	{
+		cll::var a("\"hello\""), b("\" world\"");
+		for (size_t i = 0; i < n; ++i) bench::keep((a + b).value);
+	});
+
+	// ARRAYS
+	std::string large("[");
+	for (size_t i = 0; i < 10000; ++i) large += ((i != 0) ? "," : "") + std::to_string(i);
+	large += "]";
+
+	const cll::var arr(large);
+
+	suite.add("array/getElement/first", [arr](size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) bench::keep(arr.getElement(0).value);
+	});
+
+	suite.add("array/getElement/middle", [arr](size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) bench::keep(arr.getElement(5000).value);
+	});
+
+	suite.add("array/getElements", [arr](size_t n)
+	{
+		for (size_t i = 0; i < n; ++i) bench::keep(arr.getElements().back().value);
+	});
+
+	// FUNCTIONS
+	std::vector<std::string> fib =
+	{
+		"function fib",
+		"{",
+		"	if argv[0] < 2; return argv[0]",
+		"	return fib(argv[0] - 1) + fib(argv[0] - 2)",
+		"}"
+	};
+
+	addScript(suite, "function/recursion", fib, "x = fib(10)");
+	addScript(suite, "function/call", { "function id", "{", "	return argv[0]", "}" }, "x = id(1)");
+	addScript(suite, "script/loop", {}, "for i = 0, i < 100, i += 1 { x = i * 2 }");
+
+	// FILES
+	const std::string file = "cll_bench_fopen.txt";
+	{
+		std::ofstream out(file, std::ios::out | std::ios::trunc);
+		for (size_t i = 0; i < 20000; ++i) out << "line number " << i << " with some \"quoted\" text\n";
+	}
+
+	addScript(suite, "io/fopen", {}, "lines = fopen(\"" + file + "\")");
+
+	// SCRIPTS
+	addPrimes(suite, "prime_naive", 100);
+	addPrimes(suite, "prime_naive", 200);
+	addPrimes(suite, "prime_recursive", 500);
+	addPrimes(suite, "prime_recursive", 1000);
+	addPrimes(suite, "prime_sieve", 200);
+	addPrimes(suite, "prime_sieve", 400);
+
+	std::vector<std::vector<bench::result>> all;
+	for (size_t i = 0; i < runs; ++i) all.emplace_back(suite.run());
+
+	std::vector<bench::result> results = bench::merge(all);
+
+	// Benchmarks that regressed are run again - check fails only if regression is reproduced, so that noise does not fail it
+	std::string report;
+	bool passed = true;
+
+	if (baseline != "")
+	{
+		std::vector<bench::result> base;
+		std::string error;
+
+		if (!bench::load(baseline, base, error))
+		{
+			std::cerr << "Baseline could not be read - " << error << '\n';
+			std::remove(file.c_str());
+			return 1;
+		}
+
+		std::vector<std::string> regressed;
+		passed = bench::compare(base, results, threshold, report, regressed);
+
+		if (!passed && !regressed.empty())
+		{
+			std::cerr << '\n' << report << "\nRegressed benchmarks are run again to confirm regression\n";
+
+			suite.names = regressed;
+			std::vector<bench::result> again = suite.run();
+
+			report.clear();
+			regressed.clear();
+			passed = bench::compare(base, again, threshold, report, regressed);
+		}
+	}
+
+	std::remove(file.c_str());
+
+	if (output == "") std::cout << bench::json(results);
+	else
+	{
+		std::ofstream out(output, std::ios::out | std::ios::trunc);
+		out << bench::json(results);
+
+		if (!out.good())
+		{
+			std::cerr << "Results could not be written to '" << output << "'\n";
+			return 1;
+		}
+	}
+
+	if (baseline != "")
+	{
+		std::cerr << '\n' << report;
+		if (!passed) std::cerr << "Performance regressed by more than " << threshold << "%\n";
+	}
+
+	return (passed) ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include "var.hpp"
+
+#include <string>
+#include <vector>
+
+// Contains functions that compile scripts into tokens and cache compiled scripts on disk.
+// Compiled script is a vector of already tokenized lines, so it can be executed without lexing.
+//
+// Cache is kept next to the script in a file with '.cllc' extension (script.cll -> script.cllc).
+// Layout of cache file (all numbers are stored in native byte order):
+//
+// "CLLC"			 magic
+// u32				 format revision
+// u32 + chars		 interpreter version
+// u64				 hash of the script source (FNV-1a)
+// u32				 number of lines
+// for every line:
+//	 u32			 number of tokens
+//	 for every token:
+//	   u8			 type
+//	   u64			 buffor
+//	   u32 + chars	 value
+//
+// Cache is stale when its revision, version or hash differs - script is then compiled from source
+// and cache is rewritten.
+
+namespace cll
+{
+	typedef std::vector<std::vector<var>> compiled; // Holds tokens of every line of a script
+
+	unsigned long long hashSource(const char* data, const size_t& n); // Returns FNV-1a hash of the source
+
+	void compile(const char* data, const size_t& n, compiled& c); // Tokenizes source line by line
+	bool compile(const std::string& f, compiled& c, const std::string& version, const bool& cache); // Compiles file by path (optionally through cache)
+
+	bool loadCache(const std::string& f, const std::string& version, const unsigned long long& hash, compiled& c);
+	bool saveCache(const std::string& f, const std::string& version, const unsigned long long& hash, const compiled& c);
+}
\ No newline at end of file
@@ -0,0 +1,124 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include "cache.hpp"
+#include "fiber.hpp"
+#include "profiler.hpp"
+#include "sampler.hpp"
+#include "stats.hpp"
+#include "stream.hpp"
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+
+// Contains Context struct that holds state of a running script, such as opened file handles, random number generator, profilers and stats.
+// Context is shared by interpreter and all of its nested scopes and functions,
+// but every interpreter created with 'cll' statement (or by user) gets its own one.
+//
+// It also contains Execution struct that holds state of script executed step by step (in a fiber), limits of script and depth of its calls.
+// Scripts started with 'cll' statement run in the same fiber as their parent, so they share it.
+//
+// Calls of user defined functions are not limited by native stack - when less than 'reserve' bytes of actual stack are left (see Fiber::floor),
+// next calls continue on a new stack (Fiber) of 'segment' bytes that is allocated lazily, so recursion is limited only by 'limit'.
+// Segments are small and filled up, so address space of deep recursion is close to memory that its frames really use.
+// Script executed step by step gets segments too - when it is suspended inside of one, every segment below passes suspension on
+// to the one that resumed it, until fiber of script returns to host. Resuming script resumes them again in reverse order. Call in tail position ('return f(...)') does not nest at all,
+// it is left to the function that returns it (see Interpreter::tailCall).
+//
+// Builtin functions that need it take interpreter as their first parameter and access it by Interpreter::getContext().
+
+namespace cll
+{
+	// Reason why script executed step by step returned from Interpreter::resume()
+	// EXHAUSTED and EXPIRED mean that script used up its step budget or passed its deadline - it can be resumed after they are changed
+	enum class State
+	{
+		FINISHED, FAILED, YIELDED, SLEEPING, WAITING, EXHAUSTED, EXPIRED
+	};
+
+	struct Execution
+	{
+		Fiber* fiber; // Fiber in which script runs - nullptr if it is not executed step by step
+		Fiber* stack; // Stack segment that calls run on - nullptr if they run on stack of script (its fiber or thread)
+		State state; // Reason of last suspension
+		size_t slice; // Number of lines after which script yields - 0 means that it yields only at 'sleep' and 'cin'
+		size_t steps; // Lines executed since last yield
+		bool cancelled; // Set when suspended script has to be aborted
+		std::chrono::steady_clock::time_point wake; // Time at which sleeping script wants to be resumed
+
+		// LIMITS - checked at every loop iteration and function call (step)
+		size_t budget; // Number of steps that script can execute - 0 means no limit
+		size_t used; // Steps executed since budget was set
+		bool timed; // Determines whether deadline is set
+		std::chrono::steady_clock::time_point deadline; // Time after which script is stopped
+
+		// CALLS OF USER DEFINED FUNCTIONS
+		static const size_t segment = 524288; // Size of stack segment in bytes - stack of thread is assumed to have at least this much left when script calls first function
+		static const size_t reserve = 131072; // Stack kept free for one call and builtin functions that it calls
+		size_t depth; // Number of functions that did not return yet
+		size_t limit; // Maximal depth of calls - 0 means no limit
+
+		Execution() : fiber(nullptr), stack(nullptr), state(State::FINISHED), slice(0), steps(0), cancelled(false), budget(0), used(0), timed(false), depth(0), limit(100000) {};
+
+		// Returns from actual stack segment (or fiber of script) to the code that resumed it
+		inline void yield() { ((stack != nullptr) ? stack : fiber)->yield(); };
+
+		// Suspends script with given reason, returns false if script was cancelled in the meantime
+		inline bool suspend(const State& s)
+		{
+			if (fiber == nullptr) return true;
+
+			state = s;
+			yield();
+
+			return !cancelled;
+		};
+	};
+
+	// Call of user defined function in tail position - it is executed by the function that returns it instead of nesting in it
+	struct deferred
+	{
+		std::string name;
+		std::vector<var> args;
+		std::shared_ptr<const compiled> lines; // nullptr if there is no pending call
+		unsigned int id = 0; // Id of function name interned by sampler
+	};
+
+	struct Context
+	{
+		long long handles; // Last used file handle
+		std::map<long long, std::unique_ptr<Reader>> readers; // Opened file readers by their handles
+		std::map<long long, std::unique_ptr<Writer>> writers; // Opened file writers by their handles
+		std::mt19937_64 random; // Generator used by 'rand' - use generator() to access it
+		bool seeded; // Determines whether generator was seeded
+		std::shared_ptr<Execution> execution; // State of step by step execution
+		std::shared_ptr<Profiler> profiler; // Profiler of script - nullptr if profiling is disabled
+		std::shared_ptr<Sampler::track> track; // Track of sampling profiler - nullptr if sampling is disabled
+		Stats stats; // Counters of interpreter internals - counted only if CLL_STATS is defined
+		deferred tail; // Pending call of 'return f(...)' statement
+
+		// PERIODIC DUMP OF STATS
+		std::function<void(const Stats&)> dump; // Called with stats at most once per interval
+		std::chrono::steady_clock::duration interval;
+		std::chrono::steady_clock::time_point next; // Time of the next dump
+
+		Context() : handles(0), seeded(false), execution(std::make_shared<Execution>()) {};
+
+		inline Profiler* profiling() const { return profiler.get(); };
+		inline Sampler::track* sampling() const { return track.get(); };
+
+		// Generator is seeded from std::random_device only when it is used for the first time,
+		// because most scripts (and workers or pooled interpreters that run them) never use it
+		inline std::mt19937_64& generator()
+		{
+			if (!seeded) seed(std::random_device()());
+			return random;
+		};
+
+		inline void seed(const unsigned long long& s) { random.seed(s); seeded = true; };
+	};
+}
\ No newline at end of file
@@ -2,32 +2,42 @@
 
 // Author: Bartosz Niciak
 
-#include "var.hpp"
+#include "cache.hpp"
+#include "memo.hpp"
 
+#include <memory>
 #include <vector>
 
-// Contains defined struct that holds function name (used in CLL) and scope lines of that function.
+// Contains defined struct that holds function name (used in CLL) and already tokenized scope lines of that function.
+// Lines are shared by every copy of the function, so they are tokenized once - when function is defined.
+// Pure function (defined as 'function pure name') also shares table of its results (see Memo).
+// Name of function is interned by sampler when function is defined (see Sampler).
 // It also contains vector wrapper for that struct that allows for function searching, addition and deletion.
+// Copies of wrapper share one vector until one of them changes it (copy-on-write), so nested scopes copy it cheaply.
 
 namespace cll
 {
 	struct defined
 	{
 		std::string name;
-		std::vector<std::string> lines;
+		std::shared_ptr<const compiled> lines;
+		std::shared_ptr<Memo> memo; // Results of pure function - nullptr if function is not pure
+		unsigned int id; // Id of name interned by sampler - it is interned once, so that calls do not lock sampler
 
-		defined(const std::string& n, const std::vector<std::string>& l) : name(n), lines(l) {};
+		defined(const std::string& n, const std::shared_ptr<const compiled>& l, const std::shared_ptr<Memo>& m = nullptr, const unsigned int& i = 0) : name(n), lines(l), memo(m), id(i) {};
 	};
 	
 	class Defined
 	{
-		std::vector<defined> funs;
+		std::shared_ptr<std::vector<defined>> funs;
+
+		void own(); // Makes own copy of functions if they are shared
 
 	public:
 
-		Defined() {};
+		Defined();
 
-		defined get(const std::string& n);
+		defined get(const std::string& n) const;
 		void add(const defined& f);
 		void del(const std::string& n);
 	};
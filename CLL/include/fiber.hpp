@@ -0,0 +1,67 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <functional>
+
+#ifndef _WIN32
+#include <ucontext.h>
+#endif
+
+// Contains Fiber class - stackful coroutine that runs function on its own stack.
+// Function can suspend itself at any depth of calls by yield() and it continues from that point when fiber is resumed.
+// It is implemented with ucontext on POSIX systems and with Fibers on Windows.
+//
+// Interpreter runs scripts executed step by step (Interpreter::resume) in fibers,
+// so that scripts can be suspended in the middle of loops and function calls.
+// Fiber can be resumed on any thread, but only by one thread at a time.
+// Default size of stack is 8 MB (like main thread on Linux) - memory is used only when stack grows into it.
+//
+// Every thread knows the lowest address of stack that it runs on (floor()) - fiber sets it to its own stack when it is resumed
+// and restores it when it yields or returns. Stack of thread itself has unknown bounds, so its floor is set by the code that uses it.
+// Stacks are assumed to grow down, like on every platform that CLL supports.
+
+namespace cll
+{
+	class Fiber
+	{
+		std::function<void()> fun;
+		size_t siz; // Size of stack in bytes
+		bool begun; // Determines whether fiber was resumed at least once
+		bool done; // Determines whether function has returned
+		const char* low; // Lowest address of stack that function can use - nullptr until it is known
+
+#ifdef _WIN32
+		void* fiber;
+		void* caller; // Fiber that resumed this one
+		bool converted; // Determines whether thread was converted to fiber by resume()
+
+		static void __stdcall entry(void* p);
+#else
+		char* stack; // Mapped memory with guard page at the bottom
+		ucontext_t context;
+		ucontext_t caller; // Context that resumed this fiber
+
+		static void entry();
+#endif
+
+	public:
+
+		// CONSTRUCTORS //
+		Fiber(const std::function<void()>& f, const size_t& stack = 8388608);
+		~Fiber();
+
+		Fiber(const Fiber&) = delete;
+		Fiber& operator=(const Fiber&) = delete;
+
+		// METHODS //
+		bool resume(); // Runs fiber until it yields or returns, returns false if it has already returned
+		void yield(); // Suspends fiber and returns from resume() - must be called from inside of fiber
+
+		inline bool good() const { return siz > 0; }; // Returns false if stack could not be allocated
+		inline bool started() const { return begun; };
+		inline bool finished() const { return done; };
+
+		static const char*& floor(); // Returns lowest address of stack that actual thread runs on - nullptr if it is not set
+	};
+}
\ No newline at end of file
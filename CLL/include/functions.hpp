@@ -4,34 +4,45 @@
 
 #include "var.hpp"
 
+#include <memory>
 #include <vector>
 
 // Contains function struct that holds function name (used in CLL) and pointer to that function.
+// Function can also take interpreter that calls it as its first parameter (e.g. to access its context).
 // It also contains vector wrapper for that struct that allows for function searching, addition and deletion.
+// Copies of wrapper share one vector until one of them changes it (copy-on-write), so copying is cheap.
 //
 // Builtin function can be found in 'functions' directory.
 
 namespace cll
 {
+	class Interpreter;
+
 	struct function
 	{
 		std::string name;
 		var(*fun)(const std::vector<var>&);
+		var(*ifun)(Interpreter&, const std::vector<var>&); // Function that needs access to the interpreter that calls it
 
-		function(const std::string& n, var(*f)(const std::vector<var>&)) : name(n), fun(f) {};
+		function() : name(""), fun(nullptr), ifun(nullptr) {};
+		function(const std::string& n, var(*f)(const std::vector<var>&)) : name(n), fun(f), ifun(nullptr) {};
+		function(const std::string& n, var(*f)(Interpreter&, const std::vector<var>&)) : name(n), fun(nullptr), ifun(f) {};
 
 		inline var exec(const std::vector<var>& args) { return fun(args); };
+		inline var exec(Interpreter& i, const std::vector<var>& args) { return (ifun) ? ifun(i, args) : fun(args); };
 	};
 	
 	class Functions
 	{
-		std::vector<function> funs;
+		std::shared_ptr<std::vector<function>> funs;
+
+		void own(); // Makes own copy of functions if they are shared
 
 	public:
 
 		Functions();
 
-		function get(const std::string& n);
+		function get(const std::string& n) const;
 		void add(const function& f);
 		void del(const std::string& n);
 	};
@@ -1,37 +1,71 @@
 #pragma once
 
 #include "../var.hpp"
+#include "../interpreter.hpp"
 
 #include <fstream>
 #include <vector>
 
 namespace cll
 {
+	// Appends text to string literal with escaped backslashes, quotation marks and new lines
+	void escape(std::string& out, const std::string& l)
+	{
+		for (size_t i = 0; i < l.length(); ++i)
+		{
+			if (l[i] == '\\') out += "\\\\";
+			else if (l[i] == '"') out += "\\\"";
+			else if (l[i] == '\'') out += "\\\'";
+			else if (l[i] == '\n') out += "\\n";
+			else out += l[i];
+		}
+	}
+
 	var fopen(const std::vector<var>& args)
 	{
 		if (args.empty()) return var("[]");
 		std::fstream f(args[0].getString(), std::ios::in);
 		std::string l;
-		var ret("[]");
+		std::string ret("[");
 
+		// Array is built as one string - appending every line to var would copy whole array each time
 		if (f.good())
 		{
 			while (std::getline(f, l))
 			{
-				std::string b = "";
-				for (size_t i = 0; i < l.length(); ++i)
-				{
-					if (l[i] == '\\') b += "\\\\";
-					else if (l[i] == '"') b += "\\\"";
-					else if (l[i] == '\'') b += "\\\'";
-					else b += l[i];
-				}
-				ret += var("\"" + b + "\"");
+				if (ret.length() > 1) ret += ',';
+				ret += '"';
+				escape(ret, l);
+				ret += '"';
 			}
 		}
 
 		f.close();
-		return ret;
+		return var(ret + "]");
+	}
+
+	// Appends values the way they are written to files - every value (or array element) in new line
+	// Args parameter also includes commas, so values are taken starting from 'from' index with step of 2
+	void serialize(std::string& out, const std::vector<var>& args, const size_t& from)
+	{
+		for (size_t i = from; i < args.size(); i += 2)
+		{
+			if (args[i].type == Type::ARRAY)
+			{
+				std::vector<var> elems = args[i].getElements();
+
+				for (size_t ii = 0; ii < elems.size(); ++ii)
+				{
+					out += elems[ii].getString();
+					out += '\n';
+				}
+			}
+			else
+			{
+				if (args[i].type != Type::CHAR) out += args[i].getString();
+				out += '\n';
+			}
+		}
 	}
 
 	var fwrite(const std::vector<var>& args)
@@ -42,15 +76,9 @@ namespace cll
 
 		if (f.good())
 		{
-			for (size_t i = 2; i < args.size(); i += 2)
-			{
-				for (size_t ii = 0; ii < args[i].getSize(); ++ii)
-				{
-					f << args[i].getElement(ii).getString();
-					if (args[i].type == Type::ARRAY) f << '\n';
-				}
-				if (args[i].type != Type::ARRAY) f << '\n';
-			}
+			std::string out;
+			serialize(out, args, 2);
+			f.write(out.data(), out.length());
 		}
 		else return var("0");
 
@@ -66,15 +94,9 @@ namespace cll
 
 		if (f.good())
 		{
-			for (size_t i = 2; i < args.size(); i += 2)
-			{
-				for (size_t ii = 0; ii < args[i].getSize(); ++ii)
-				{
-					f << args[i].getElement(ii).getString();
-					if (args[i].type == Type::ARRAY) f << '\n';
-				}
-				if (args[i].type != Type::ARRAY) f << '\n';
-			}
+			std::string out;
+			serialize(out, args, 2);
+			f.write(out.data(), out.length());
 		}
 		else return var("0");
 
@@ -97,4 +119,122 @@ namespace cll
 
 		return (ret.getSize() > 1) ? ret : ret.getElement(0);
 	}
+
+	// Streaming file functions //
+
+	var freader(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.empty()) return var("0");
+
+		size_t siz = (args.size() > 2 && args[2].getInt() > 0) ? size_t(args[2].getInt()) : 65536;
+		std::unique_ptr<Reader> r(new Reader(args[0].getString(), siz));
+
+		if (!r->good()) return var("0");
+
+		Context& c = in.getContext();
+		c.readers[++c.handles] = std::move(r);
+
+		return std::to_string(c.handles);
+	}
+
+	var readline(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.empty()) return var("\"\"");
+
+		Context& c = in.getContext();
+		auto it = c.readers.find(args[0].getInt());
+		if (it == c.readers.end()) return var("\"\"");
+
+		std::string l;
+		std::string ret("\"");
+
+		it->second->readLine(l);
+		escape(ret, l);
+
+		return var(ret + "\"");
+	}
+
+	var readchunk(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.size() < 3) return var("\"\"");
+
+		Context& c = in.getContext();
+		auto it = c.readers.find(args[0].getInt());
+		if (it == c.readers.end() || args[2].getInt() <= 0) return var("\"\"");
+
+		std::string l;
+		std::string ret("\"");
+
+		it->second->readChunk(l, size_t(args[2].getInt()));
+		escape(ret, l);
+
+		return var(ret + "\"");
+	}
+
+	var feof(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.empty()) return var("1");
+
+		Context& c = in.getContext();
+		auto it = c.readers.find(args[0].getInt());
+
+		return (it == c.readers.end() || it->second->eof()) ? var("1") : var("0");
+	}
+
+	var fwriter(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.empty()) return var("0");
+
+		bool append = (args.size() > 2 && args[2].getBool());
+		size_t siz = (args.size() > 4 && args[4].getInt() >= 0) ? size_t(args[4].getInt()) : 65536;
+		std::unique_ptr<Writer> w(new Writer(args[0].getString(), append, siz));
+
+		if (!w->good()) return var("0");
+
+		Context& c = in.getContext();
+		c.writers[++c.handles] = std::move(w);
+
+		return std::to_string(c.handles);
+	}
+
+	var fput(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.size() < 2) return var("0");
+
+		Context& c = in.getContext();
+		auto it = c.writers.find(args[0].getInt());
+		if (it == c.writers.end()) return var("0");
+
+		std::string out;
+		serialize(out, args, 2);
+
+		return (it->second->write(out)) ? var("1") : var("0");
+	}
+
+	var fflush(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.empty()) return var("0");
+
+		Context& c = in.getContext();
+		auto it = c.writers.find(args[0].getInt());
+		if (it == c.writers.end()) return var("0");
+
+		return (it->second->flush()) ? var("1") : var("0");
+	}
+
+	var fclose(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.empty()) return var("0");
+
+		Context& c = in.getContext();
+		var ret("[]");
+
+		for (size_t i = 0; i < args.size(); i += 2)
+		{
+			size_t closed = c.readers.erase(args[i].getInt()) + c.writers.erase(args[i].getInt());
+			ret += std::to_string(closed);
+		}
+
+		return (ret.getSize() > 1) ? ret : ret.getElement(0);
+	}
 }
\ No newline at end of file
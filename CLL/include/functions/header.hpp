@@ -6,6 +6,7 @@
 #include "time.hpp"
 #include "type.hpp"
 #include "file.hpp"
+#include "parallel.hpp"
 
 // Header file for all CLL builtin functions
 //
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "../var.hpp"
+#include "../interpreter.hpp"
+#include "../threads.hpp"
+
+#include <mutex>
+#include <vector>
+
+namespace cll
+{
+	// Joins values into an array - results of parallel functions are built here at once
+	var toArray(const std::vector<var>& v)
+	{
+		std::string ret("[");
+
+		for (size_t i = 0; i < v.size(); ++i)
+		{
+			if (i != 0) ret += ',';
+			ret += (v[i].value != "") ? v[i].value : "0"; // Function that returned nothing gives 0
+		}
+
+		ret += ']';
+
+		var arr;
+		arr.value.swap(ret);
+		arr.type = Type::ARRAY;
+
+		return arr;
+	}
+
+	// Calls function 'fn' for every argument list from 'args' and puts returned values in 'results'.
+	// If there are at least 'threshold' calls, they run on threads of the shared pool in isolated interpreters,
+	// so they do not share any variables, and their output is written in order of calls after all of them are done.
+	// Otherwise they run one by one on the calling interpreter. Returns false if any call failed.
+	bool parallel(Interpreter& in, const std::string& fn, const std::vector<std::vector<var>>& args, std::vector<var>& results, const size_t& threshold)
+	{
+		size_t n = args.size();
+		results.assign(n, var());
+
+		if (n < threshold)
+		{
+			for (size_t i = 0; i < n; ++i)
+			{
+				results[i] = in.call(fn, args[i]);
+				if (in.getError() != "") return false;
+			}
+
+			return true;
+		}
+
+		std::vector<std::string> outputs(n);
+		std::string error("");
+		std::mutex m;
+
+		unsigned long long seed = in.getContext().generator()(); // Calls are reproducible if script is seeded
+		ThreadPool& pool = ThreadPool::shared();
+
+		pool.run(n, [&](size_t begin, size_t end)
+		{
+			std::string* out = nullptr;
+			std::unique_ptr<Interpreter> worker = in.isolate(std::make_shared<CallbackSink>([&out](const char* s, size_t k) { out->append(s, k); }));
+
+			for (size_t i = begin; i < end; ++i)
+			{
+				out = &outputs[i];
+				worker->seed(seed + i);
+
+				results[i] = worker->call(fn, args[i]);
+
+				if (worker->getError() != "")
+				{
+					std::lock_guard<std::mutex> lock(m);
+					if (error == "") error = worker->getError();
+					worker->clearError();
+				}
+			}
+		}, std::max(n / ((pool.size() + 1) * 8), size_t(1)));
+
+		for (size_t i = 0; i < n; ++i) if (!outputs[i].empty()) in.write(outputs[i]);
+
+		if (error != "") in.setError(error);
+		return error == "";
+	}
+
+	// Calls function 'fn' for every index in [0, n) - every iteration runs in isolated interpreter on the shared pool.
+	// Returns array of returned values or, if reduction function is given, result of reduction (done in order of iterations).
+	//
+	// Usage: pfor(n, "fn") or pfor(n, "fn", "reduce_fn", init)
+	var pfor(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.size() < 3) return var("[]");
+		if (args[0].getInt() <= 0) return (args.size() > 6) ? args[6] : var("[]");
+
+		std::vector<std::vector<var>> params(size_t(args[0].getInt()));
+		for (size_t i = 0; i < params.size(); ++i) params[i].emplace_back(std::to_string(i));
+
+		std::vector<var> results;
+		if (!parallel(in, args[2].getString(), params, results, 1)) return var("0");
+
+		if (args.size() < 5) return toArray(results);
+
+		// Reduction is sequential, so its result does not depend on number of threads
+		std::string reduce = args[4].getString();
+		var ret = (args.size() > 6) ? args[6] : results[0];
+
+		for (size_t i = (args.size() > 6) ? 0 : 1; i < results.size(); ++i)
+		{
+			ret = in.call(reduce, { ret, results[i] });
+			if (in.getError() != "") return var("0");
+		}
+
+		ret.name.clear();
+		return ret;
+	}
+
+	// Arrays with less elements are processed by 'map' and 'filter' on the calling thread
+	const size_t parallelThreshold = 256;
+
+	// Returns array of values returned by function 'fn' (user defined or builtin) for every element
+	//
+	// Usage: map(array, "fn")
+	var map(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.size() < 3) return var("[]");
+
+		std::vector<var> elems = args[0].getElements();
+		std::vector<std::vector<var>> params(elems.size());
+		for (size_t i = 0; i < elems.size(); ++i) params[i].emplace_back(elems[i]);
+
+		std::vector<var> results;
+		if (!parallel(in, args[2].getString(), params, results, parallelThreshold)) return var("0");
+
+		return toArray(results);
+	}
+
+	// Returns array of elements for which function 'fn' returned true
+	//
+	// Usage: filter(array, "fn")
+	var filter(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.size() < 3) return var("[]");
+
+		std::vector<var> elems = args[0].getElements();
+		std::vector<std::vector<var>> params(elems.size());
+		for (size_t i = 0; i < elems.size(); ++i) params[i].emplace_back(elems[i]);
+
+		std::vector<var> results;
+		if (!parallel(in, args[2].getString(), params, results, parallelThreshold)) return var("0");
+
+		std::vector<var> kept;
+		for (size_t i = 0; i < elems.size(); ++i) if (results[i].getBool()) kept.emplace_back(elems[i]);
+
+		return toArray(kept);
+	}
+
+	// Folds elements with function 'fn' from left to right, starting with 'init' (or first element).
+	// Every step depends on the previous one, so reduction is always done on the calling thread.
+	//
+	// Usage: reduce(array, "fn") or reduce(array, "fn", init)
+	var reduce(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.size() < 3) return var("0");
+
+		std::vector<var> elems = args[0].getElements();
+		if (elems.empty()) return (args.size() > 4) ? args[4] : var("0");
+
+		std::string fn = args[2].getString();
+		var ret = (args.size() > 4) ? args[4] : elems[0];
+
+		for (size_t i = (args.size() > 4) ? 0 : 1; i < elems.size(); ++i)
+		{
+			ret = in.call(fn, { ret, elems[i] });
+			if (in.getError() != "") return var("0");
+		}
+
+		ret.name.clear();
+		return ret;
+	}
+}
\ No newline at end of file
@@ -1,19 +1,19 @@
 #pragma once
 
 #include "../var.hpp"
+#include "../interpreter.hpp"
 
 #include <vector>
 #include <random>
 
 namespace cll
 {
-	var rand(const std::vector<var>& args)
+	var rand(Interpreter& in, const std::vector<var>& args)
 	{
 		double low = 0.0, high = 1.0;
 
-		static std::random_device rd;
-		static std::mt19937 random_engine;
-		random_engine.seed(rd());
+		// Every interpreter has its own generator, so interpreters running on different threads do not share it
+		std::mt19937_64& random_engine = in.getContext().generator();
 
 		if (args.empty())
 		{
@@ -42,4 +42,50 @@ namespace cll
 
 		return (ret.getSize() > 1) ? ret : ret.getElement(0);
 	}
+
+	// Sets seed of interpreter generator, so that following numbers are reproducible
+	var srand(Interpreter& in, const std::vector<var>& args)
+	{
+		unsigned long long seed = (args.empty()) ? std::random_device()() : (unsigned long long)args[0].getInt();
+		in.seed(seed);
+
+		return std::to_string(seed);
+	}
+
+	// Returns array of n random numbers - much faster than calling 'rand' n times
+	var randfill(Interpreter& in, const std::vector<var>& args)
+	{
+		if (args.empty() || args[0].getInt() <= 0) return var("[]");
+
+		double low = 0.0, high = 1.0;
+
+		if (args.size() > 4)
+		{
+			low = args[2].getDouble();
+			high = args[4].getDouble();
+		}
+		else if (args.size() > 2) high = args[2].getDouble();
+
+		std::mt19937_64& random_engine = in.getContext().generator();
+		std::uniform_real_distribution<double> dist(low, high);
+
+		size_t n = size_t(args[0].getInt());
+		std::string ret("[");
+		ret.reserve(n * 10 + 2);
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			if (i != 0) ret += ',';
+			ret += std::to_string(dist(random_engine));
+		}
+
+		ret += ']';
+
+		// Array is built here, so its type does not have to be checked again
+		var arr;
+		arr.value.swap(ret);
+		arr.type = Type::ARRAY;
+
+		return arr;
+	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "../var.hpp"
+#include "../interpreter.hpp"
 
 #include <vector>
 #include <chrono>
@@ -52,11 +53,31 @@ namespace cll
 		return (ret.getSize() > 1) ? ret : ret.getElement(0);
 	}
 
-	var sleep(const std::vector<var>& args)
+	// Script executed step by step is suspended instead of blocking the thread - host resumes it after wake time
+	var sleep(Interpreter& in, const std::vector<var>& args)
 	{
 		if (!args.empty())
 		{
-			std::this_thread::sleep_for(std::chrono::milliseconds(args[0].getInt()));
+			Execution& exec = *in.getContext().execution;
+
+			if (exec.fiber == nullptr)
+			{
+				std::this_thread::sleep_for(std::chrono::milliseconds(args[0].getInt()));
+				return args[0];
+			}
+
+			exec.wake = std::chrono::steady_clock::now() + std::chrono::milliseconds(args[0].getInt());
+
+			do
+			{
+				if (!exec.suspend(State::SLEEPING))
+				{
+					in.setError("Script was cancelled!");
+					return var("0");
+				}
+			}
+			while (std::chrono::steady_clock::now() < exec.wake);
+
 			return args[0];
 		}
 
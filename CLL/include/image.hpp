@@ -0,0 +1,26 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include "var.hpp"
+#include "functions.hpp"
+#include "defined.hpp"
+
+#include <vector>
+
+// Contains Image struct - immutable snapshot of initialized interpreter (its variables, builtin and user defined functions).
+// Image is made by Interpreter::snapshot() and interpreters are created from it by constructor that takes it.
+//
+// Interpreters created from image share its function tables until they change them (copy-on-write),
+// so workers that need the same prelude can start in microseconds instead of running it again.
+// Image is never changed after it is made, so it can be shared between threads.
+
+namespace cll
+{
+	struct Image
+	{
+		std::vector<var> vars;
+		Functions functions;
+		Defined dfunctions;
+	};
+}
\ No newline at end of file
@@ -3,12 +3,36 @@
 // Author: Bartosz Niciak
 
 #include "var.hpp"
+#include "cache.hpp"
+#include "context.hpp"
+#include "fiber.hpp"
 #include "functions.hpp"
 #include "defined.hpp"
+#include "image.hpp"
+#include "program.hpp"
+#include "sink.hpp"
 
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
+// Contains Interpreter class that executes CLL code line by line.
+//
+// Script can also be executed step by step - it is started by startFile() or startVector() and executed by resume().
+// It runs in its own fiber, so resume() returns whenever script yields: at 'sleep' (without blocking the thread),
+// before 'cin' and after every n lines if time slice is set. This way one thread can run many scripts at once.
+//
+// Thread safety:
+// - Independent interpreters share no mutable state, so each of them can run on its own thread.
+//   Every interpreter has its own variables, functions, context (file handles, random number generator) and sink.
+// - One interpreter (with its nested scopes and functions) must not be used by more than one thread at the same time.
+// - Compiled modules of 'include' and 'cll' statements are shared between threads - their cache is guarded by a mutex.
+// - Interpreters that have no sink write to std::cout - writes are safe, but output of different threads can interleave.
+//   Sinks are not synchronized, so every thread should set its own one.
+// - 'cin' statement and file functions are not synchronized between interpreters that use the same streams or files.
+
 namespace cll
 {
 	class Interpreter
@@ -19,15 +43,23 @@ namespace cll
 		std::string error; // Holds errors
 		std::string filename; // Holds filename
 		std::string output; // Holds output - usefull for terminal applications
+		std::string fname; // Name of user defined function that is executed - empty outside of functions
+		unsigned int sid; // Id of executed unit (function, file or "script") interned by sampler
+		std::string interned; // Name of unit that sid was interned for - unit is interned again only when it changes
 
 		// FUNCTIONS
 		Functions functions;
 		Defined dfunctions;
 
+		std::shared_ptr<Context> context; // State of running script - shared with nested scopes
+		std::shared_ptr<Sink> sink; // Destination of output - std::cout is used if it is not set
+		std::unique_ptr<Fiber> task; // Fiber of script executed step by step
+		bool succeeded; // Result of script executed step by step
+
 		// SCOPE SPECIFIC VARIABLES //
 		std::vector<var> previous_action; // Holds previous flow managed bare word (if, while, ...)
 		std::vector<var> action; // Holds actual flow managed bare word (if, while, ...)
-		std::vector<std::string> lines; // Holds actual scope - to be executed after closing bracket
+		compiled lines; // Holds tokens of actual scope - to be executed after closing bracket
 		unsigned int scope; // Holds actual scope number
 
 		// OTHER VARIABLES
@@ -39,24 +71,37 @@ namespace cll
 		bool debug; // Determines whether to output additional debug information about tokens
 		bool enabledIO; // Determines whether to give ability to use 'cin' and 'cout' statements
 		bool enabledOutput; // Determines whether to output additional info to "output" variable
+		bool cached; // Determines whether to cache compiled scripts on disk (.cllc files)
 
 		// PRIVATE METHODS //
-		inline virtual void write(const std::string& s) { if (enabledIO) std::cout << s; };
 		bool errorLog(); // Returns false if there is an error and prints them with std::cout (if logging is enabled)
 		bool newInterpreter(const std::vector<var>& v); // Creates new instance of interpreter - for file in file execution
-		var newFunction(const std::vector<var>& args, const std::vector<std::string>& l); // Function that creates new scope
-		bool newScope(const std::vector<std::string>& l, const std::vector<var>& action = { var("1") }, const size_t& id = 0); // Creates new instance of interpreter - for scope execution
+		var newFunction(const defined& f, const std::vector<var>& args); // Function that creates new scope
+		var execFunction(const defined& f, const std::vector<var>& args); // Executes function and calls in its tail position
+		bool tailCall(const var& v); // Leaves call in 'return f(...)' statement to the function that returns it
+		bool newScope(const compiled& l, const std::vector<var>& action = { var("1") }, const size_t& id = 0); // Creates new instance of interpreter - for scope execution
 		bool parse(const std::vector<var>& v); // Checks line syntax
 		bool bare(const std::vector<var>& v); // Procesess bare words and also some spiecial tokens
 		bool readScope(const std::vector<var>& v);
+		bool readTokens(const std::vector<var>& l); // Interpretes only one already tokenized line
+		bool readCompiled(const compiled& c); // Interpretes compiled script line by line
 		std::vector<var> math(const std::vector<var>& v, const bool& comma = true); // Procesess math equations
 		bool afterparse(const std::vector<var>& v);
+		bool start(const std::function<bool()>& f, const size_t& stack); // Prepares fiber that executes given function
+		bool step(); // Counts step of script and checks its limits, returns false if script has to be stopped
+		void dumpStats(); // Passes stats to dump callback if its interval passed
+		const std::string& unit() const; // Returns name of code that is executed (function, file or "script") - for profiler
+		unsigned int unitId(const std::string& u); // Returns id of unit name interned by sampler
+		static const std::vector<var>& defaults(); // Returns variables that every interpreter starts with (and, endl, true, ...)
+
+		Interpreter(const std::shared_ptr<Context>& c, const std::vector<var>& v); // Constructor of nested scope or function - it uses context of parent instead of creating its own
 
 	public:
 
 		// CONSTRUCTORS //
-		Interpreter() : error(""), filename(""), output(""), scope(0), line(0), returned(""), continued(false), 
-						broke(false), log(false), debug(false), enabledIO(false), enabledOutput(false)
+		Interpreter() : error(""), filename(""), output(""), sid(0), context(std::make_shared<Context>()), succeeded(false),
+						scope(0), line(0), returned(""), continued(false), broke(false), log(false), debug(false),
+						enabledIO(false), enabledOutput(false), cached(false)
 		{
 			vars.reserve(100);
 			output.reserve(20);
@@ -65,26 +110,40 @@ namespace cll
 			action.reserve(15);
 			lines.reserve(50);
 
-			vars =
-			{
-				var("and", "&&"),
-				var("endl", "'\\n'"),
-				var("false", "0"),
-				var("is", "=="),
-				var("not", "!"),
-				var("or", "||"),
-				var("true", "1"),
-				var("xor", "^")
-			};
+			vars = defaults();
 		};
 
 		Interpreter(const std::vector<var>& v);
 		Interpreter(const std::string& f);
+		Interpreter(const std::shared_ptr<const Image>& i); // Constructor that starts from snapshot of other interpreter
+		virtual ~Interpreter();
 
 		// METHODS INTERPRETING THEIR PARAMETERS //
 		bool readVector(const std::vector<std::string>& v);
 		bool readLine(const std::string& l); // Interpretes only one line
 		bool readFile(const std::string& f); // Interpretes file by path
+		bool run(const Program& p); // Executes already tokenized program - it can be executed again without lexing
+
+		// STEP BY STEP EXECUTION //
+		bool startFile(const std::string& f, const size_t& stack = 8388608); // Prepares file to be executed by resume(), returns false if other script is started
+		bool startVector(const std::vector<std::string>& v, const size_t& stack = 8388608); // Prepares lines to be executed by resume()
+		bool startProgram(const Program& p, const size_t& stack = 8388608); // Prepares program to be executed by resume()
+		State resume(); // Executes started script until it yields or ends
+		void cancel(); // Aborts started script - it ends with an error at the point where it was suspended
+
+		inline void setSlice(const size_t& n) { context->execution->slice = n; }; // Script yields after every n lines (0 disables it)
+		inline bool isStarted() const { return task != nullptr; };
+		inline std::chrono::steady_clock::time_point getWake() const { return context->execution->wake; }; // Returns time at which sleeping script wants to be resumed
+
+		// LIMITS OF SCRIPT //
+		// Limits are checked at every loop iteration and function call. Script that exceeds them fails with an error,
+		// but script executed step by step is paused instead (resume() returns EXHAUSTED or EXPIRED) and it can be resumed after limits are changed.
+		inline void setBudget(const size_t& n) { context->execution->budget = n; context->execution->used = 0; }; // Sets number of steps that script can execute (0 disables it)
+		inline void setDeadline(const std::chrono::steady_clock::time_point& t) { context->execution->deadline = t; context->execution->timed = true; };
+		inline void setTimeout(const std::chrono::milliseconds& t) { setDeadline(std::chrono::steady_clock::now() + t); };
+		inline void clearDeadline() { context->execution->timed = false; };
+		inline size_t getSteps() const { return context->execution->used; }; // Returns number of steps executed since budget was set
+		inline void setDepth(const size_t& n) { context->execution->limit = n; }; // Sets maximal depth of nested function calls - script that exceeds it always fails (0 disables it)
 
 		// INTERPRETER VARIABLES ACCESSING METHODS //
 		bool setVar(const var& v); // Sets or adds variable to interpreter by var abstract
@@ -97,8 +156,14 @@ namespace cll
 		// FUNCTIONS
 		inline void addFunction(const function& f) { functions.add(f); };
 		inline void addFunction(const std::string& n, var(*f)(const std::vector<var>&)) { addFunction(function(n, f)); };
+		inline void addFunction(const std::string& n, var(*f)(Interpreter&, const std::vector<var>&)) { addFunction(function(n, f)); };
 		inline void deleteFunction(const std::string& n) { functions.del(n); };
 
+		// SNAPSHOTS //
+		std::shared_ptr<const Image> snapshot() const; // Returns immutable copy of variables and functions - interpreters can be created from it
+		void reset(); // Restores state of newly created interpreter in place - reserved memory is kept
+		void reset(const std::shared_ptr<const Image>& i); // Restores state of interpreter created from snapshot in place
+
 		// METHODS THAT CHANGE BEHAVIOUR OF INTERPRETER //
 		inline void enableLogging()  { log = true; };
 		inline void disableLogging() { log = false; };
@@ -116,7 +181,44 @@ namespace cll
 		inline void disableOutput() { enabledOutput = false; };
 		inline void toggleOutput() { enabledOutput = !enabledOutput; };
 
+		inline void enableCache() { cached = true; };
+		inline void disableCache() { cached = false; };
+		inline void toggleCache() { cached = !cached; };
+
+		void setSink(const std::shared_ptr<Sink>& s, const size_t& chunk = 8192); // Sets output destination, output is batched into chunks of given size (0 disables batching)
+		inline void resetSink() { flush(); sink.reset(); }; // Restores std::cout as output destination
+		void flush(); // Writes batched output to its destination
+		virtual void write(const char* s, const size_t& n); // Writes output to sink or std::cout
+		inline void write(const std::string& s) { write(s.data(), s.length()); };
+
+		// PROFILING //
+		// Profiler records time of every line and function call of script, its nested scopes, functions and 'cll' scripts.
+		// If path is given, reports are saved to it when the last interpreter that uses the profiler is destroyed or profiling is disabled.
+		void enableProfiling(const std::string& p = "");
+		inline void disableProfiling() { context->profiler.reset(); };
+		inline std::shared_ptr<Profiler> getProfiler() const { return context->profiler; };
+
+		// Sampling profiler (Sampler::global()) records position of script periodically - it is much cheaper than profiler, but not exact.
+		// Sampler has to be started by host, enableSampling() only makes the script visible to it.
+		inline void enableSampling() { if (!context->track) context->track = Sampler::global().attach(); };
+		inline void disableSampling() { context->track.reset(); };
+		inline bool isSampled() const { return context->track != nullptr; };
+
+		// STATS //
+		// Counters are available only if library is built with CLL_STATS defined (see Stats::enabled())
+		inline const Stats& stats() const { return context->stats; };
+		inline void clearStats() { context->stats.clear(); };
+		void setStatsDump(const std::function<void(const Stats&)>& f, const std::chrono::milliseconds& interval); // Calls f with stats periodically during execution (empty f disables it)
+		inline std::shared_ptr<const Memo> getMemo(const std::string& n) const { return dfunctions.get(n).memo; }; // Returns table of results of pure function (nullptr if function is not pure)
+
+		inline void seed(const unsigned long long& s) { context->seed(s); }; // Seeds random number generator of script for reproducible runs
+
+		// METHODS FOR BUILTIN FUNCTIONS //
+		var call(const std::string& n, const std::vector<var>& args); // Calls user defined or builtin function by name with given arguments
+		std::unique_ptr<Interpreter> isolate(const std::shared_ptr<Sink>& s = nullptr) const; // Creates interpreter with the same functions, but with no variables, its own context and given sink
+
 		// OTHER PUBLIC METHODS //
+		inline void setError(const std::string& e) { error = e; };
 		inline void clearError() { error.clear(); };
 		inline void clearOutput() { output.clear(); };
 		inline var getReturned() const { return returned; }; 
@@ -126,5 +228,6 @@ namespace cll
 		inline std::string getFilename() const { return filename; }; // Returns non-empty string if interpreter interpretes a file
 		inline std::string getVersion() const { return version; };
 		inline std::string getOutput() const { return output; };
+		inline Context& getContext() { return *context; }; // Returns state of running script (e.g. opened file handles)
 	};
 }
\ No newline at end of file
@@ -52,4 +52,5 @@
 namespace cll
 {
 	std::vector<var> lexer(const std::string& l);
+	std::vector<var> lexer(const char* begin, const char* end); // Tokenizes characters in range [begin, end) without copying them
 }
\ No newline at end of file
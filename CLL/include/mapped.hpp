@@ -0,0 +1,41 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <string>
+#include <vector>
+
+// Contains MappedFile class that gives read-only access to whole file content.
+// Regular files are mapped into memory (mmap or MapViewOfFile on Windows), so nothing is copied.
+// Files that can not be mapped (pipes, devices, ...) are read into a buffer instead.
+
+namespace cll
+{
+	class MappedFile
+	{
+		const char* view; // Points to mapped memory or to buffer
+		size_t length; // Size of file content in bytes
+		bool mapped; // Determines whether view points to mapped memory or to buffer
+		bool opened; // Determines whether file was opened successfully
+		std::vector<char> buffer; // Holds file content if file could not be mapped
+
+	public:
+
+		// CONSTRUCTORS //
+		MappedFile() : view(nullptr), length(0), mapped(false), opened(false) {};
+		MappedFile(const std::string& f) : MappedFile() { open(f); };
+		~MappedFile() { close(); };
+
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		// METHODS //
+		bool open(const std::string& f); // Maps or reads file by path
+		void close(); // Unmaps file and frees buffer
+
+		inline bool good() const { return opened; };
+		inline bool isMapped() const { return mapped; };
+		inline const char* data() const { return view; };
+		inline size_t size() const { return length; };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,60 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include "var.hpp"
+
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Contains Memo class - bounded table of results of pure user defined function (defined as 'function pure name { ... }').
+// Results are keyed by values of arguments, so pure function is executed only once for the same arguments
+// and its side effects (e.g. 'cout') are not repeated when result is taken from the table.
+//
+// Table is shared by every copy of the function - also by interpreters on other threads (e.g. 'pfor'), so it is guarded by a mutex.
+// When table is full, the least recently used result is evicted.
+
+namespace cll
+{
+	class Memo
+	{
+	public:
+
+		struct counters
+		{
+			size_t hits; // Calls answered from table
+			size_t misses; // Calls that executed function
+			size_t evictions; // Results removed to make room for new ones
+			size_t size; // Results in table
+		};
+
+	private:
+
+		typedef std::list<std::pair<std::string, var>> entries;
+
+		mutable std::mutex m;
+		entries results; // The most recently used result is first
+		std::unordered_map<std::string, entries::iterator> index; // Results by their keys
+		size_t capacity;
+		size_t hits, misses, evictions;
+
+	public:
+
+		Memo(const size_t& c = 4096) : capacity(c), hits(0), misses(0), evictions(0) {};
+
+		Memo(const Memo&) = delete;
+		Memo& operator=(const Memo&) = delete;
+
+		static std::string key(const std::vector<var>& args); // Returns key of arguments (commas between them are skipped)
+
+		bool get(const std::string& k, var& v); // Returns false if there is no result for key
+		void put(const std::string& k, const var& v);
+		void clear();
+
+		counters stats() const;
+	};
+}
\ No newline at end of file
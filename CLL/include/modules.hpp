@@ -0,0 +1,21 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include "cache.hpp"
+
+#include <memory>
+#include <string>
+
+// Contains process-wide cache of compiled modules - scripts executed by 'include' and 'cll' statements.
+// Modules are keyed by canonical path of the script and validated by its modification time and size,
+// so that edited script is compiled again on its next use.
+//
+// Compiled modules are immutable, so they can be shared by every interpreter (also between threads).
+
+namespace cll
+{
+	std::shared_ptr<const compiled> getModule(const std::string& f, const std::string& version, const bool& cache); // Returns compiled module or nullptr if file could not be opened
+	void invalidateModule(const std::string& f); // Removes module from cache, so that it will be compiled on its next use
+	void clearModules(); // Removes all modules from cache
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include "interpreter.hpp"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Contains Pool class that hands out interpreters and takes them back when job is done.
+// Released interpreters are reset in place (Interpreter::reset), so they keep memory reserved by previous jobs
+// and short jobs pay neither for construction of interpreter nor for allocations.
+//
+// Pool can be given a snapshot (Image) - then every acquired interpreter starts from it.
+// Pool is thread-safe, so workers of a thread pool can share one.
+
+namespace cll
+{
+	class Pool
+	{
+		std::mutex m;
+		std::vector<std::unique_ptr<Interpreter>> free; // Interpreters ready to be acquired
+		std::shared_ptr<const Image> image; // Snapshot that acquired interpreters start from (optional)
+		size_t limit; // Maximal number of kept interpreters - released ones above it are destroyed
+
+	public:
+
+		// CONSTRUCTORS //
+		Pool(const size_t& l = 64) : limit(l) { free.reserve(limit); };
+		Pool(const std::shared_ptr<const Image>& i, const size_t& l = 64) : image(i), limit(l) { free.reserve(limit); };
+
+		Pool(const Pool&) = delete;
+		Pool& operator=(const Pool&) = delete;
+
+		// METHODS //
+		std::unique_ptr<Interpreter> acquire(); // Returns interpreter in state of newly created one
+		void release(std::unique_ptr<Interpreter> i); // Resets interpreter and keeps it for the next acquire()
+
+		void reserve(const size_t& n); // Creates interpreters up front, so that first jobs do not create them
+		size_t size(); // Returns number of interpreters ready to be acquired
+	};
+}
\ No newline at end of file
@@ -0,0 +1,125 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Contains Profiler class that measures how many times every line and user defined function was executed and how long it took.
+// Profiler is enabled by Interpreter::enableProfiling() and it is shared by nested scopes, functions and scripts of 'cll' statement.
+//
+// Lines are identified by unit and line number:
+// - unit of line in file is its filename and line is counted from the beginning of that file
+// - unit of line in user defined function is its name and line is number of statement in its body (brackets are statements too)
+// - unit of line executed by readVector or readLine is "script"
+// Times of lines are inclusive - line that calls function or closes loop also contains time of that function or loop.
+//
+// Reports:
+// - flat()      - lines and functions sorted by their total time
+// - tree()      - call tree of executed scripts and functions with their counts and times
+// - collapsed() - call stacks with their self time in microseconds - input of flamegraph.pl and similar tools
+//
+// Profiler is not thread-safe - interpreters created by isolate() (e.g. by 'pfor') are not profiled.
+
+namespace cll
+{
+	class Profiler
+	{
+	public:
+
+		using clock = std::chrono::steady_clock;
+
+		struct record
+		{
+			size_t count;
+			clock::duration time;
+		};
+
+		struct node
+		{
+			std::string name;
+			size_t parent;
+			size_t count;
+			clock::duration time; // Inclusive time
+			std::vector<size_t> children;
+		};
+
+	private:
+
+		std::unordered_map<std::string, size_t> ids; // Ids of units by their names
+		std::vector<std::string> units; // Names of units by their ids
+		std::unordered_map<unsigned long long, record> lines; // Records of lines by unit id (high bits) and line number (low bits)
+		std::vector<node> nodes; // Call tree - the first node is the root that holds scripts executed by host
+		size_t current; // Node of function that is executed at the moment
+		std::string path; // File to which reports are saved when profiler is destroyed
+
+		void flatten(const size_t& n, std::string& prefix, std::string& out) const;
+		void print(const size_t& n, const size_t& depth, std::string& out) const;
+
+	public:
+
+		Profiler(const std::string& p = "") : nodes(1, node{ "", 0, 1, clock::duration::zero(), {} }), current(0), path(p) {};
+		~Profiler();
+
+		Profiler(const Profiler&) = delete;
+		Profiler& operator=(const Profiler&) = delete;
+
+		// RECORDING //
+		void addLine(const std::string& unit, const unsigned int& line, const clock::duration& d);
+		size_t enter(const std::string& name); // Enters call of function, returns its node
+		void leave(const size_t& n, const clock::duration& d); // Leaves call of function that was entered
+
+		void clear(); // Removes everything that was recorded
+
+		// REPORTS //
+		std::string flat() const;
+		std::string tree() const;
+		std::string collapsed() const;
+		bool save(const std::string& p) const; // Writes flat and tree report to file and collapsed stacks to file with '.folded' extension appended
+
+		inline void setPath(const std::string& p) { path = p; };
+		inline std::string getPath() const { return path; };
+	};
+
+	// Measures time of one line, does nothing if profiler is not set
+	struct lineProbe
+	{
+		Profiler* profiler;
+		const std::string& unit;
+		unsigned int line;
+		Profiler::clock::time_point begin;
+
+		lineProbe(Profiler* p, const std::string& u, const unsigned int& l) : profiler(p), unit(u), line(l)
+		{
+			if (profiler != nullptr) begin = Profiler::clock::now();
+		};
+
+		~lineProbe()
+		{
+			if (profiler != nullptr) profiler->addLine(unit, line, Profiler::clock::now() - begin);
+		};
+	};
+
+	// Measures time of one function call, does nothing if profiler is not set
+	struct callProbe
+	{
+		Profiler* profiler;
+		size_t node;
+		Profiler::clock::time_point begin;
+
+		callProbe(Profiler* p, const std::string& name) : profiler(p), node(0)
+		{
+			if (profiler == nullptr) return;
+
+			node = profiler->enter(name);
+			begin = Profiler::clock::now();
+		};
+
+		~callProbe()
+		{
+			if (profiler != nullptr) profiler->leave(node, Profiler::clock::now() - begin);
+		};
+	};
+}
\ No newline at end of file
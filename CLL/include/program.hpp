@@ -0,0 +1,42 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include "cache.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+// Contains Program class - script that is tokenized once and executed by Interpreter::run() any number of times.
+// Program is immutable and copying it only shares its tokens, so one program can be executed
+// by any number of interpreters at once (also on different threads).
+//
+// Program is made by one of its static methods:
+// - fromFile()   - reads and tokenizes file by path
+// - fromString() - tokenizes source text (lines separated by '\n')
+// - fromVector() - tokenizes every line of vector
+
+namespace cll
+{
+	class Program
+	{
+		std::shared_ptr<const compiled> tokens; // Tokens of every line
+		std::string filename; // Path of script - empty if it was not read from file
+		std::string error; // Holds error of reading file
+
+	public:
+
+		Program() : tokens(std::make_shared<const compiled>()) {};
+
+		static Program fromFile(const std::string& f);
+		static Program fromString(const std::string& s);
+		static Program fromVector(const std::vector<std::string>& v);
+
+		inline bool good() const { return error == ""; };
+		inline size_t size() const { return tokens->size(); }; // Returns number of lines
+		inline const compiled& getTokens() const { return *tokens; };
+		inline std::string getFilename() const { return filename; };
+		inline std::string getError() const { return error; };
+	};
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Contains Sampler class - sampling profiler for scripts that can not be instrumented fully (see Profiler).
+// Interpreters with sampling enabled (Interpreter::enableSampling()) publish their actual line and stack of user defined functions
+// to their track with relaxed atomic stores, which costs about as much as counting lines.
+// Side thread of sampler reads every track periodically and counts hits of lines and call stacks.
+//
+// Names of units (files, functions and "script") are interned - tracks hold only their ids.
+// Interpreters intern functions when they are defined and files when they start them, never at every call.
+// Names have their own lock, so interning does not wait for sampling of tracks.
+// Reports:
+// - report()    - hot lines and functions (self and total samples) sorted by number of samples
+// - collapsed() - sampled call stacks ending with line - input of flamegraph.pl and similar tools
+
+namespace cll
+{
+	class Sampler
+	{
+	public:
+
+		static const size_t depth = 64; // Deeper frames are counted, but not recorded
+
+		// Position of one running script - written by interpreter and read by sampler
+		struct track
+		{
+			std::atomic<unsigned long long> position; // Unit id (high bits) and line number (low bits)
+			std::atomic<size_t> frames; // Number of entered user defined functions
+			std::atomic<unsigned int> stack[depth]; // Unit ids of entered functions
+			std::atomic<int> running; // Number of scripts that execute on this track - it is not sampled if it is 0
+
+			track() : position(0), frames(0), running(0)
+			{
+				for (size_t i = 0; i < depth; ++i) stack[i].store(0, std::memory_order_relaxed);
+			};
+
+			inline void at(const unsigned int& unit, const unsigned int& line)
+			{
+				position.store((static_cast<unsigned long long>(unit) << 32) | line, std::memory_order_relaxed);
+			};
+
+			inline void push(const unsigned int& unit)
+			{
+				size_t n = frames.load(std::memory_order_relaxed);
+				if (n < depth) stack[n].store(unit, std::memory_order_relaxed);
+				frames.store(n + 1, std::memory_order_release);
+			};
+
+			inline void pop() { frames.store(frames.load(std::memory_order_relaxed) - 1, std::memory_order_release); };
+		};
+
+	private:
+
+		std::mutex interning; // Guards ids and names - it is locked after m if both are locked
+		std::unordered_map<std::string, unsigned int> ids; // Ids of units by their names
+		std::vector<std::string> names; // Names of units by their ids - id 0 is empty
+
+		std::mutex m; // Guards everything below except of worker
+		std::vector<std::shared_ptr<track>> tracks;
+		std::unordered_map<unsigned long long, size_t> lines; // Hits of lines
+		std::map<std::vector<unsigned long long>, size_t> stacks; // Hits of call stacks - the last element is position
+		size_t samples; // Number of sampled positions
+
+		std::thread worker;
+		std::condition_variable cv;
+		bool stopped;
+		std::chrono::microseconds interval;
+
+		void sample(); // Records position of every running track
+		void prune(); // Removes tracks released by interpreters
+		void work();
+		std::string position(const unsigned long long& p) const; // Returns position as "unit:line" - interning mutex has to be locked
+		std::string name(const unsigned long long& u) const; // Returns name of unit - interning mutex has to be locked
+
+	public:
+
+		Sampler() : names(1), samples(0), stopped(true), interval(1000) {};
+		~Sampler() { stop(); };
+
+		Sampler(const Sampler&) = delete;
+		Sampler& operator=(const Sampler&) = delete;
+
+		static Sampler& global(); // Returns sampler used by interpreters
+
+		void start(const std::chrono::microseconds& i = std::chrono::microseconds(1000)); // Starts side thread that samples tracks every interval
+		void stop();
+		void clear(); // Removes collected samples
+
+		std::shared_ptr<track> attach(); // Returns new track that is sampled until it is released by interpreters
+		unsigned int intern(const std::string& n); // Returns id of unit name
+
+		// REPORTS //
+		std::string report();
+		std::string collapsed();
+		bool save(const std::string& p); // Writes report to file and collapsed stacks to file with '.folded' extension appended
+	};
+}
\ No newline at end of file
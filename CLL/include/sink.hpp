@@ -0,0 +1,101 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Contains Sink class - interface for destination of interpreter output ('cout' statement, errors and debug information).
+// By default interpreter writes straight to std::cout, but embedders can set their own sink
+// to capture output of scripts without going through iostreams.
+//
+// Available sinks:
+// - StreamSink   - writes to std::ostream
+// - CallbackSink - passes output to user defined function
+// - FdSink       - writes to file descriptor
+// - RingSink     - keeps last n bytes of output in preallocated ring buffer
+// - BufferedSink - batches output of another sink into large chunks
+//
+// Output is flushed when it fills a chunk, before 'cin' statement, after readFile and readVector,
+// by Interpreter::flush() or when the last interpreter that uses the sink is destroyed.
+
+namespace cll
+{
+	class Sink
+	{
+	public:
+
+		virtual ~Sink() {};
+
+		virtual void write(const char* s, const size_t& n) = 0;
+		virtual void flush() {};
+	};
+
+	class StreamSink : public Sink
+	{
+		std::ostream& out;
+
+	public:
+
+		StreamSink(std::ostream& o) : out(o) {};
+
+		inline void write(const char* s, const size_t& n) override { out.write(s, n); };
+		inline void flush() override { out.flush(); };
+	};
+
+	class CallbackSink : public Sink
+	{
+		std::function<void(const char*, size_t)> callback;
+
+	public:
+
+		CallbackSink(const std::function<void(const char*, size_t)>& c) : callback(c) {};
+
+		inline void write(const char* s, const size_t& n) override { callback(s, n); };
+	};
+
+	class FdSink : public Sink
+	{
+		int fd;
+
+	public:
+
+		FdSink(const int& f) : fd(f) {};
+
+		void write(const char* s, const size_t& n) override;
+	};
+
+	class RingSink : public Sink
+	{
+		std::vector<char> ring;
+		size_t head; // Index at which next byte will be written
+		size_t count; // Number of bytes held
+
+	public:
+
+		RingSink(const size_t& capacity) : ring(capacity), head(0), count(0) {};
+
+		void write(const char* s, const size_t& n) override;
+
+		std::string str() const; // Returns held bytes from the oldest one
+		inline void clear() { head = 0; count = 0; };
+	};
+
+	class BufferedSink : public Sink
+	{
+		std::shared_ptr<Sink> target;
+		std::string buffer;
+		size_t chunk;
+
+	public:
+
+		BufferedSink(const std::shared_ptr<Sink>& t, const size_t& c = 8192) : target(t), chunk(c) { buffer.reserve(chunk); };
+		~BufferedSink() { flush(); };
+
+		void write(const char* s, const size_t& n) override;
+		void flush() override;
+	};
+}
\ No newline at end of file
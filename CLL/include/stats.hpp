@@ -0,0 +1,54 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <string>
+
+// Contains Stats struct - counters of interpreter internals used to tune deployments.
+// Counting is compiled in only if CLL_STATS is defined (CMake option CLL_STATS), otherwise CLL_COUNT does nothing
+// and Interpreter::stats() always returns zeros.
+//
+// Counters are added to stats of interpreter that is executed on actual thread (Stats::active()),
+// so nested scopes, functions, scripts of 'cll' statement and lexer count into the same stats.
+// Work done by isolated interpreters on other threads (e.g. by 'pfor') is not counted.
+
+#ifdef CLL_STATS
+#define CLL_COUNT(counter, n) do { if (cll::Stats* s = cll::Stats::active()) s->counter += (n); } while (0)
+#else
+#define CLL_COUNT(counter, n) do {} while (0)
+#endif
+
+namespace cll
+{
+	struct Stats
+	{
+		size_t lines; // Lines (and expressions) lexed
+		size_t tokens; // Tokens produced by lexer
+		size_t reductions; // Calls of math() - expressions reduced
+		size_t lookups; // Calls of getVar()
+		size_t misses; // Lookups of variables that do not exist
+		size_t assignments; // Calls of setVar()
+		size_t insertions; // Assignments that created new variable
+		size_t scopes; // Nested scopes created (every loop and if statement)
+		size_t calls; // Calls of user defined functions
+		size_t memoized; // Calls of pure functions answered from their tables (not counted as calls)
+		size_t interpreters; // Interpreters created by 'cll' statement and isolate()
+		size_t builtins; // Calls of builtin functions
+		size_t bytes; // Bytes allocated on heap for values of tokens and variables - short values fit into string itself and are not counted
+
+		Stats() { clear(); };
+
+		void clear();
+		std::string str() const; // Returns counters as "name: value" lines
+
+		static bool enabled(); // Returns whether counting was compiled in
+		static Stats*& active(); // Returns stats that actual thread counts into - nullptr if none
+
+		// Returns bytes that string holds on heap - 0 if it fits into its small buffer
+		static inline size_t heap(const std::string& s)
+		{
+			static const size_t local = std::string().capacity();
+			return (s.capacity() > local) ? s.capacity() : 0;
+		};
+	};
+}
\ No newline at end of file
@@ -0,0 +1,75 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <streambuf>
+#include <string>
+
+// Contains stream classes that back file handles returned by builtin functions.
+//
+// Reader reads file lazily through a buffer of user defined size,
+// so that scripts can process large files line by line (or chunk by chunk) in constant memory.
+//
+// Writer keeps file opened and collects written data in a buffer of user defined size.
+// Buffer is written when it gets full, when it is flushed or when writer is destroyed.
+// Data that does not fit in the buffer is written along with it by one batched system call (writev).
+//
+// readValues() reads whole stream of whitespace separated values straight into an array value.
+
+namespace cll
+{
+	class Reader
+	{
+		std::ifstream file;
+		std::unique_ptr<char[]> buffer; // Buffer used by file stream
+
+	public:
+
+		// CONSTRUCTORS //
+		Reader(const std::string& f, const size_t& siz = 65536);
+
+		// METHODS //
+		bool readLine(std::string& l); // Reads one line (without new line character), returns false if there was nothing to read
+		bool readChunk(std::string& c, const size_t& n); // Reads up to n characters, returns false if there was nothing to read
+
+		inline bool good() const { return file.is_open() && !file.bad(); };
+		inline bool eof() { return !good() || file.peek() == std::char_traits<char>::eof(); };
+	};
+
+	class Writer
+	{
+		std::string buffer;
+		size_t capacity; // Size of buffer - 0 means that every write goes straight to the file
+
+#ifdef _WIN32
+		std::FILE* file;
+#else
+		int fd;
+#endif
+
+		bool writeAll(const char* s, const size_t& n); // Writes buffer and then passed data to the file
+
+	public:
+
+		// CONSTRUCTORS //
+		Writer(const std::string& f, const bool& append = false, const size_t& siz = 65536);
+		~Writer();
+
+		Writer(const Writer&) = delete;
+		Writer& operator=(const Writer&) = delete;
+
+		// METHODS //
+		bool write(const char* s, const size_t& n); // Buffers data, returns false if data could not be written
+		inline bool write(const std::string& s) { return write(s.data(), s.length()); };
+		bool flush(); // Writes buffered data to the file
+
+		bool good() const;
+	};
+
+	// Reads whitespace separated values from stream buffer until its end and appends them to array value (without brackets).
+	// Integers and decimals are parsed directly, everything else becomes a string. Returns number of read values.
+	size_t readValues(std::streambuf* in, std::string& arr, const size_t& siz = 65536);
+}
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Contains ThreadPool class - pool of worker threads used by parallel builtin functions (e.g. 'pfor').
+//
+// Every worker has its own queue of tasks (ranges of indices). Worker takes tasks from the back of its own queue
+// and steals them from the front of other queues when it runs out of work (work stealing).
+// Ranges are split in halves before they are executed, so idle workers can steal large parts of work.
+//
+// Thread that calls run() also executes tasks until the whole range is done,
+// so parallel calls nested inside of other parallel calls do not deadlock.
+
+namespace cll
+{
+	class ThreadPool
+	{
+		// Range of indices passed to run() - it is done when 'remaining' gets to 0
+		struct batch
+		{
+			const std::function<void(size_t, size_t)>& fun;
+			size_t grain;
+			std::atomic<size_t> remaining;
+			std::mutex m;
+			std::condition_variable cv;
+
+			batch(const std::function<void(size_t, size_t)>& f, const size_t& n, const size_t& g) : fun(f), grain(g), remaining(n) {};
+		};
+
+		struct task
+		{
+			std::shared_ptr<batch> b;
+			size_t begin;
+			size_t end;
+		};
+
+		struct queue
+		{
+			std::mutex m;
+			std::deque<task> tasks;
+		};
+
+		std::vector<std::thread> workers;
+		std::vector<std::unique_ptr<queue>> queues; // One queue for each worker
+
+		std::mutex m; // Guards sleeping of workers
+		std::condition_variable cv;
+		std::atomic<size_t> pending; // Number of queued tasks
+		std::atomic<size_t> next; // Queue for tasks pushed by threads that are not workers
+		bool stopped;
+
+		void work(const size_t& id);
+		void push(const task& t, const size_t& id);
+		bool take(task& t, const size_t& id);
+		void execute(task t, const size_t& id);
+
+	public:
+
+		// CONSTRUCTORS //
+		ThreadPool(const size_t& threads);
+		~ThreadPool();
+
+		ThreadPool(const ThreadPool&) = delete;
+		ThreadPool& operator=(const ThreadPool&) = delete;
+
+		static ThreadPool& shared(); // Process-wide pool with one worker less than there are cores (calling thread is the last one)
+
+		// METHODS //
+		void run(const size_t& n, const std::function<void(size_t, size_t)>& f, const size_t& grain = 1); // Calls f for ranges that cover [0, n) and waits for all of them
+		inline size_t size() const { return workers.size(); }; // Returns number of workers
+	};
+}
\ No newline at end of file
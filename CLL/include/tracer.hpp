@@ -0,0 +1,115 @@
+#pragma once
+
+// Author: Bartosz Niciak
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Contains Tracer class that records begin and end events of scopes, user defined function calls, 'include' statements,
+// scripts of 'cll' statement and builtin function calls of all interpreters in the process.
+// Events are written in Chrome trace-event format - they can be opened in chrome://tracing or Perfetto.
+//
+// Tracing is disabled by default and costs one relaxed atomic load per event then.
+// Every thread writes events to its own ring buffer without locks - when ring is full, the oldest events are overwritten.
+// Ring of thread that ended is reused by the next new thread, so memory is bounded by number of threads that run at once
+// and events of threads that reused one ring share one track of trace. Tracer has to outlive threads that record to it.
+// Events should be collected by json() or save() after stop(), otherwise events that are written at the same time can be torn.
+//
+// Scripts executed step by step (in fibers) on one thread share its ring, so their events interleave.
+
+namespace cll
+{
+	class Tracer
+	{
+	public:
+
+		// Kind of traced code - category of event
+		enum class Category : unsigned char
+		{
+			SCOPE, FUNCTION, INCLUDE, SCRIPT, BUILTIN
+		};
+
+		struct event
+		{
+			long long time; // Nanoseconds since tracer was started
+			Category category;
+			char phase; // 'B' for begin and 'E' for end
+			char name[46]; // Name is cut to fit, so that writing event does not allocate
+		};
+
+	private:
+
+		// Events of one thread - written only by that thread
+		struct ring
+		{
+			std::vector<event> events;
+			std::atomic<size_t> head; // Number of events written since tracer was started
+			size_t thread; // Id of thread in trace
+
+			ring(const size_t& capacity, const size_t& t) : events(capacity), head(0), thread(t) {};
+		};
+
+		// Ring that thread uses - it is returned to tracer when thread ends
+		struct owner
+		{
+			Tracer* tracer;
+			ring* r;
+
+			owner() : tracer(nullptr), r(nullptr) {};
+			~owner() { release(); };
+
+			void release();
+		};
+
+		std::atomic<bool> enabled;
+		std::atomic<long long> epoch; // Time of start() in nanoseconds of steady clock - read by threads that record events
+		std::mutex m; // Guards lists of rings - locked only when thread writes its first event or ends
+		std::vector<std::unique_ptr<ring>> rings; // All rings, also of threads that ended - their events are still collected
+		std::vector<ring*> free; // Rings of threads that ended - reused by new threads
+		size_t capacity; // Events kept per thread - applies to rings of threads that did not trace yet
+
+		ring* local(); // Returns ring of actual thread
+
+	public:
+
+		Tracer() : enabled(false), epoch(0), capacity(65536) {};
+
+		Tracer(const Tracer&) = delete;
+		Tracer& operator=(const Tracer&) = delete;
+
+		static Tracer& global(); // Returns tracer used by interpreters
+
+		void start(const size_t& events = 65536); // Removes previous events and starts tracing with given ring capacity for new threads
+		inline void stop() { enabled.store(false, std::memory_order_release); };
+		inline bool active() const { return enabled.load(std::memory_order_relaxed); };
+
+		void record(const Category& c, const char& phase, const std::string& name);
+
+		std::string json(); // Returns collected events as Chrome trace-event JSON
+		bool save(const std::string& path); // Writes json() to file
+	};
+
+	// Records begin event when created and end event when destroyed, if tracing is active
+	struct traceScope
+	{
+		Tracer::Category category;
+		const std::string* name;
+
+		traceScope(const Tracer::Category& c, const std::string& n) : category(c), name(nullptr)
+		{
+			if (!Tracer::global().active()) return;
+
+			name = &n;
+			Tracer::global().record(category, 'B', n);
+		};
+
+		~traceScope()
+		{
+			if (name != nullptr) Tracer::global().record(category, 'E', *name);
+		};
+	};
+}
\ No newline at end of file
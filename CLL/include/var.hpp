@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
 
 // Contains var struct that acts as a dynamic variable and also as a token (all tokens are variables in CLL).
 // Every object of it contains information such as : name, value, type (as enum).
@@ -72,6 +73,7 @@ namespace cll
 		float getFloat() const;
 		double getDouble() const;
 		var getElement(const size_t& n) const;
+		std::vector<var> getElements() const; // Returns all elements at once - faster than calling getElement for every index
 		std::string getRawString() const; // Returns value as string with escape represented
 		std::string getString() const; // Returns value as string with escape characters acting as they should
 		std::string getError() const; // Returns non-empty string when some error occured
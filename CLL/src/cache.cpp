@@ -0,0 +1,210 @@
+#include "cache.hpp"
+
+// Author: Bartosz Niciak
+
+#include "lexer.hpp"
+#include "mapped.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <thread>
+
+namespace cll
+{
+	static const char magic[4] = { 'C', 'L', 'L', 'C' };
+	static const unsigned int revision = 1; // Must be increased every time layout of cache or tokens changes
+
+	// Returns path of cache file for given script
+	static std::string cachePath(const std::string& f)
+	{
+		if (f.length() > 4 && f.compare(f.length() - 4, 4, ".cll") == 0) return f + "c";
+		return f + ".cllc";
+	}
+
+	// Helper struct that reads numbers and strings from mapped cache file with bounds checking
+	struct reader
+	{
+		const char* it;
+		const char* end;
+
+		template<typename T>
+		bool get(T& v)
+		{
+			if (size_t(end - it) < sizeof(T)) return false;
+			std::memcpy(&v, it, sizeof(T));
+			it += sizeof(T);
+			return true;
+		}
+
+		bool get(std::string& s)
+		{
+			unsigned int len = 0;
+			if (!get(len) || size_t(end - it) < len) return false;
+			s.assign(it, len);
+			it += len;
+			return true;
+		}
+	};
+
+	template<typename T>
+	static void put(std::string& out, const T& v)
+	{
+		out.append(reinterpret_cast<const char*>(&v), sizeof(T));
+	}
+
+	static void put(std::string& out, const std::string& s)
+	{
+		put(out, (unsigned int)s.length());
+		out += s;
+	}
+
+	unsigned long long hashSource(const char* data, const size_t& n)
+	{
+		unsigned long long h = 14695981039346656037ULL;
+
+		for (size_t i = 0; i < n; ++i)
+		{
+			h ^= (unsigned char)data[i];
+			h *= 1099511628211ULL;
+		}
+
+		return h;
+	}
+
+	// Function that tokenizes source line by line (lines are split the same way as std::getline does)
+	void compile(const char* data, const size_t& n, compiled& c)
+	{
+		c.clear();
+
+		const char* it = data;
+		const char* end = data + n;
+
+		while (it < end)
+		{
+			const char* nl = static_cast<const char*>(std::memchr(it, '\n', end - it));
+			if (nl == nullptr) nl = end;
+
+			c.emplace_back(lexer(it, nl));
+			it = nl + 1;
+		}
+	}
+
+	// Function that compiles file by path
+	// If cache parameter is true it loads tokens from cache file, or rewrites it when it is stale
+	// Returns false if file could not be opened
+	bool compile(const std::string& f, compiled& c, const std::string& version, const bool& cache)
+	{
+		MappedFile source(f);
+		if (!source.good()) return false;
+
+		unsigned long long hash = hashSource(source.data(), source.size());
+		if (cache && loadCache(cachePath(f), version, hash, c)) return true;
+
+		compile(source.data(), source.size(), c);
+		if (cache) saveCache(cachePath(f), version, hash, c);
+
+		return true;
+	}
+
+	// Function that loads tokens from cache file
+	// Returns false if cache does not exist, is stale or is corrupted
+	bool loadCache(const std::string& f, const std::string& version, const unsigned long long& hash, compiled& c)
+	{
+		MappedFile file(f);
+		if (!file.good()) return false;
+
+		reader r = { file.data(), file.data() + file.size() };
+
+		char mag[4];
+		unsigned int rev = 0;
+		std::string ver;
+		unsigned long long h = 0;
+		unsigned int lines = 0;
+
+		if (!r.get(mag) || std::memcmp(mag, magic, sizeof(magic)) != 0) return false;
+		if (!r.get(rev) || rev != revision) return false;
+		if (!r.get(ver) || ver != version) return false;
+		if (!r.get(h) || h != hash) return false;
+		if (!r.get(lines)) return false;
+
+		c.clear();
+		c.resize(lines);
+
+		for (size_t i = 0; i < c.size(); ++i)
+		{
+			unsigned int tokens = 0;
+			if (!r.get(tokens)) return false;
+
+			c[i].resize(tokens);
+
+			for (size_t ii = 0; ii < c[i].size(); ++ii)
+			{
+				unsigned char type = 0;
+
+				if (!r.get(type) || type > (unsigned char)Type::BARE) return false;
+				if (!r.get(c[i][ii].buffor.i)) return false;
+				if (!r.get(c[i][ii].value)) return false;
+
+				c[i][ii].type = Type(type);
+			}
+		}
+
+		return r.it == r.end;
+	}
+
+	// Function that writes tokens to cache file
+	// File is written under temporary name first, so that other processes never see partially written cache
+	bool saveCache(const std::string& f, const std::string& version, const unsigned long long& hash, const compiled& c)
+	{
+		std::string out;
+		out.reserve(4096);
+
+		out.append(magic, sizeof(magic));
+		put(out, revision);
+		put(out, version);
+		put(out, hash);
+		put(out, (unsigned int)c.size());
+
+		for (size_t i = 0; i < c.size(); ++i)
+		{
+			put(out, (unsigned int)c[i].size());
+
+			for (size_t ii = 0; ii < c[i].size(); ++ii)
+			{
+				put(out, (unsigned char)c[i][ii].type);
+				put(out, c[i][ii].buffor.i);
+				put(out, c[i][ii].value);
+			}
+		}
+
+		std::string tmp = f + "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id()) ^ (size_t)std::chrono::steady_clock::now().time_since_epoch().count()) + ".tmp";
+
+		std::ofstream file(tmp, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!file.good()) return false;
+
+		file.write(out.data(), out.size());
+		file.close();
+
+		if (!file.good())
+		{
+			std::remove(tmp.c_str());
+			return false;
+		}
+
+		if (std::rename(tmp.c_str(), f.c_str()) != 0)
+		{
+			std::remove(f.c_str());
+
+			if (std::rename(tmp.c_str(), f.c_str()) != 0)
+			{
+				std::remove(tmp.c_str());
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
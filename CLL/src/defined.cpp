@@ -8,23 +8,41 @@
 
 namespace cll
 {
-	defined Defined::get(const std::string& n)
+	// Empty table is shared by every interpreter until it defines its first function
+	Defined::Defined()
 	{
-		size_t index = search(funs, n, 0, funs.size() - 1);
-		if (index < funs.size()) return funs[index];
-		return defined("", {});
+		static const std::shared_ptr<std::vector<defined>> empty = std::make_shared<std::vector<defined>>();
+		funs = empty;
+	}
+
+	// Functions shared with other copies are copied before they are changed
+	void Defined::own()
+	{
+		if (funs.use_count() > 1) funs = std::make_shared<std::vector<defined>>(*funs);
+	}
+
+	defined Defined::get(const std::string& n) const
+	{
+		size_t index = search(*funs, n, 0, funs->size() - 1);
+		if (index < funs->size()) return (*funs)[index];
+		return defined("", nullptr);
 	}
 
 	void Defined::add(const defined& f)
 	{
-		size_t index = search(funs, f.name, 0, funs.size() - 1);
-		if (index >= funs.size()) funs.insert(std::upper_bound(funs.begin(), funs.end(), f, [](defined a, defined b) { return a.name < b.name; }), f);
-		else funs[index] = f;
+		own();
+
+		size_t index = search(*funs, f.name, 0, funs->size() - 1);
+		if (index >= funs->size()) funs->insert(std::upper_bound(funs->begin(), funs->end(), f, [](const defined& a, const defined& b) { return a.name < b.name; }), f);
+		else (*funs)[index] = f;
 	}
 
 	void Defined::del(const std::string& n)
 	{
-		size_t index = search(funs, n, 0, funs.size() - 1);
-		if (index < funs.size()) funs.erase(funs.begin() + index);
+		size_t index = search(*funs, n, 0, funs->size() - 1);
+		if (index >= funs->size()) return;
+
+		own();
+		funs->erase(funs->begin() + index);
 	}	
 }
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "fiber.hpp"
+
+// Author: Bartosz Niciak
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#else
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#endif
+
+namespace cll
+{
+	const char*& Fiber::floor()
+	{
+		static thread_local const char* low = nullptr;
+		return low;
+	}
+
+#ifdef _WIN32
+
+	Fiber::Fiber(const std::function<void()>& f, const size_t& stack) : fun(f), siz(stack), begun(false), done(false), low(nullptr), caller(nullptr), converted(false)
+	{
+		fiber = CreateFiber(siz, &Fiber::entry, this);
+		if (fiber == nullptr) siz = 0;
+	}
+
+	Fiber::~Fiber()
+	{
+		if (fiber != nullptr) DeleteFiber(fiber);
+	}
+
+	void __stdcall Fiber::entry(void* p)
+	{
+		Fiber* self = static_cast<Fiber*>(p);
+
+		// Stack is reserved below this frame - guard pages of Windows are left out
+		char top;
+		self->low = &top - (self->siz - 65536);
+		floor() = self->low;
+
+		self->fun();
+		self->done = true;
+
+		// Fiber function must never return, because it would end the thread
+		while (true) SwitchToFiber(self->caller);
+	}
+
+	bool Fiber::resume()
+	{
+		if (done || !good()) return false;
+		begun = true;
+
+		converted = !IsThreadAFiber();
+		caller = (converted) ? ConvertThreadToFiber(nullptr) : GetCurrentFiber();
+
+		const char* outer = floor();
+		floor() = low;
+
+		SwitchToFiber(fiber);
+
+		floor() = outer;
+
+		if (converted) ConvertFiberToThread();
+		return true;
+	}
+
+	void Fiber::yield()
+	{
+		SwitchToFiber(caller);
+	}
+
+#else
+
+	// Fiber that is being started - entry function of ucontext can not take a pointer portably
+	static thread_local Fiber* starting = nullptr;
+
+	Fiber::Fiber(const std::function<void()>& f, const size_t& siz) : fun(f), siz(0), begun(false), done(false), low(nullptr), stack(nullptr)
+	{
+		size_t page = size_t(sysconf(_SC_PAGESIZE));
+		size_t length = ((siz + page - 1) / page + 1) * page;
+
+		int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+
+		// Pages are used only when stack grows into them, so space does not have to be reserved up front
+#ifdef MAP_NORESERVE
+		flags |= MAP_NORESERVE;
+#endif
+
+		void* mem = mmap(nullptr, length, PROT_READ | PROT_WRITE, flags, -1, 0);
+		if (mem == MAP_FAILED) return;
+
+		// Stack grows down, so overflow hits the guard page instead of other memory
+		mprotect(mem, page, PROT_NONE);
+
+		stack = static_cast<char*>(mem);
+		low = stack + page;
+		this->siz = length;
+
+		getcontext(&context);
+		context.uc_stack.ss_sp = stack + page;
+		context.uc_stack.ss_size = length - page;
+		context.uc_link = &caller;
+		makecontext(&context, &Fiber::entry, 0);
+	}
+
+	Fiber::~Fiber()
+	{
+		if (stack != nullptr) munmap(stack, siz);
+	}
+
+	void Fiber::entry()
+	{
+		Fiber* self = starting;
+		self->fun();
+		self->done = true;
+
+		// Returning switches to 'caller' context (uc_link)
+	}
+
+	bool Fiber::resume()
+	{
+		if (done || !good()) return false;
+		begun = true;
+
+		starting = this;
+
+		const char* outer = floor();
+		floor() = low;
+
+		swapcontext(&caller, &context);
+
+		floor() = outer;
+
+		return true;
+	}
+
+	void Fiber::yield()
+	{
+		swapcontext(&context, &caller);
+	}
+
+#endif
+}
\ No newline at end of file
@@ -9,9 +9,10 @@
 
 namespace cll
 {
-	Functions::Functions()
+	// Table of builtin functions - it is shared by every interpreter until it changes its own functions
+	static const std::shared_ptr<std::vector<function>>& builtins()
 	{
-		funs =
+		static const std::shared_ptr<std::vector<function>> funs = std::make_shared<std::vector<function>>(std::vector<function>
 		{
 			function("abs", cll::abs),
 			function("acos", cll::acos),
@@ -30,25 +31,39 @@ namespace cll
 			function("exp", cll::exp),
 			function("exp2", cll::exp2),
 			function("fappend", cll::fappend),
+			function("fclose", cll::fclose),
+			function("feof", cll::feof),
 			function("fexist", cll::fexist),
+			function("fflush", cll::fflush),
+			function("filter", cll::filter),
 			function("find", cll::find),
 			function("float", cll::tofloat),
 			function("floor", cll::floor),
 			function("fopen", cll::fopen),
+			function("fput", cll::fput),
+			function("freader", cll::freader),
 			function("fwrite", cll::fwrite),
+			function("fwriter", cll::fwriter),
 			function("hypot", cll::hypot),
 			function("int", cll::toint),
 			function("ldexp", cll::ldexp),
 			function("length", cll::length),
 			function("log", cll::log),
 			function("log10", cll::log10),
+			function("map", cll::map),
+			function("pfor", cll::pfor),
 			function("rand", cll::rand),
+			function("randfill", cll::randfill),
+			function("readchunk", cll::readchunk),
+			function("readline", cll::readline),
+			function("reduce", cll::reduce),
 			function("rfind", cll::rfind),
 			function("round", cll::round),
 			function("sin", cll::sin),
 			function("sinh", cll::sinh),
 			function("sleep", cll::sleep),
 			function("sqrt", cll::sqrt),
+			function("srand", cll::srand),
 			function("stod", cll::stod),
 			function("stof", cll::stof),
 			function("stoi", cll::stoi),
@@ -61,26 +76,41 @@ namespace cll
 			function("to_string", cll::to_string),
 			function("trunc", cll::trunc),
 			function("typeof", cll::type)
-		};
+		});
+
+		return funs;
 	}
 
-	function Functions::get(const std::string& n)
+	Functions::Functions() : funs(builtins()) {}
+
+	// Functions shared with other copies are copied before they are changed
+	void Functions::own()
 	{
-		size_t index = search(funs, n, 0, funs.size() - 1);
-		if (index < funs.size()) return funs[index];
-		return function("", nullptr);
+		if (funs.use_count() > 1) funs = std::make_shared<std::vector<function>>(*funs);
+	}
+
+	function Functions::get(const std::string& n) const
+	{
+		size_t index = search(*funs, n, 0, funs->size() - 1);
+		if (index < funs->size()) return (*funs)[index];
+		return function();
 	}
 
 	void Functions::add(const function& f)
 	{
-		size_t index = search(funs, f.name, 0, funs.size() - 1);
-		if (index >= funs.size()) funs.insert(std::upper_bound(funs.begin(), funs.end(), f, [](function a, function b) { return a.name < b.name; }), f);
-		else funs[index] = f;
+		own();
+
+		size_t index = search(*funs, f.name, 0, funs->size() - 1);
+		if (index >= funs->size()) funs->insert(std::upper_bound(funs->begin(), funs->end(), f, [](const function& a, const function& b) { return a.name < b.name; }), f);
+		else (*funs)[index] = f;
 	}
 
 	void Functions::del(const std::string& n)
 	{
-		size_t index = search(funs, n, 0, funs.size() - 1);
-		if (index < funs.size()) funs.erase(funs.begin() + index);
+		size_t index = search(*funs, n, 0, funs->size() - 1);
+		if (index >= funs->size()) return;
+
+		own();
+		funs->erase(funs->begin() + index);
 	}	
 }
\ No newline at end of file
@@ -4,30 +4,256 @@
 
 #include "utils/search.hpp"
 #include "lexer.hpp"
+#include "mapped.hpp"
+#include "modules.hpp"
+#include "tracer.hpp"
 
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
-#include <fstream>
 #include <memory>
 
 namespace cll
 {
 	const std::string Interpreter::version = "1.2.0";
+	const size_t Execution::segment;
+	const size_t Execution::reserve;
+
+	// Helper struct that flushes output of interpreter when it goes out of scope
+	struct flusher
+	{
+		Interpreter& in;
+		~flusher() { in.flush(); }
+	};
+
+	// Helper struct that sets stats that actual thread counts into for its lifetime - if outer interpreter did not set them already
+	// Force parameter makes it set them anyway - script resumed in its fiber counts into its own stats
+	struct statsGuard
+	{
+#ifdef CLL_STATS
+		Stats* previous;
+
+		statsGuard(Stats& s, const bool& force = false) : previous(Stats::active())
+		{
+			if (force || previous == nullptr) Stats::active() = &s;
+		}
+
+		~statsGuard() { Stats::active() = previous; }
+#else
+		statsGuard(Stats&, const bool& = false) {}
+#endif
+	};
+
+	// Helper struct that marks track of sampler as running while script executes
+	struct sampling
+	{
+		Sampler::track* track;
+
+		sampling(Sampler::track* t) : track(t) { if (track != nullptr) track->running.fetch_add(1, std::memory_order_relaxed); }
+		~sampling() { if (track != nullptr) track->running.fetch_sub(1, std::memory_order_relaxed); }
+	};
+
+	// Helper struct that keeps user defined function on stack of sampler track while it executes
+	// Position of caller is restored after return, so that samples are not attributed to the last line of function
+	struct sampledCall
+	{
+		Sampler::track* track;
+		unsigned long long caller;
+
+		sampledCall(Sampler::track* t, const unsigned int& unit) : track(t), caller(0)
+		{
+			if (track == nullptr) return;
+
+			caller = track->position.load(std::memory_order_relaxed);
+			track->push(unit);
+		}
+
+		~sampledCall()
+		{
+			if (track == nullptr) return;
+
+			track->pop();
+			track->position.store(caller, std::memory_order_relaxed);
+		}
+	};
 
 	// Constructor with already declared variables
-	Interpreter::Interpreter(const std::vector<var>& v)
+	Interpreter::Interpreter(const std::vector<var>& v) : Interpreter()
 	{
-		Interpreter();
+		vars = v;
+	}
+
+	// Constructor with context of parent interpreter - it does not create context that would be replaced anyway
+	Interpreter::Interpreter(const std::shared_ptr<Context>& c, const std::vector<var>& v) : error(""), filename(""), output(""), sid(0),
+						context(c), succeeded(false), scope(0), line(0), returned(""), continued(false), broke(false), 
+						log(false), debug(false), enabledIO(false), enabledOutput(false), cached(false)
+	{
+		vars.reserve(100);
+		output.reserve(20);
+
+		previous_action.reserve(15);
+		action.reserve(15);
+		lines.reserve(50);
+
 		vars = v;
 	}
 
 	// Constructor with file execution
-	Interpreter::Interpreter(const std::string& f)
+	Interpreter::Interpreter(const std::string& f) : Interpreter()
 	{
-		Interpreter();
 		readFile(f);
 	}
 
+	// Constructor with variables and functions of snapshot - function tables are shared until they are changed
+	Interpreter::Interpreter(const std::shared_ptr<const Image>& i) : Interpreter()
+	{
+		vars = i->vars;
+		functions = i->functions;
+		dfunctions = i->dfunctions;
+	}
+
+	const std::vector<var>& Interpreter::defaults()
+	{
+		static const std::vector<var> vars =
+		{
+			var("and", "&&"),
+			var("endl", "'\\n'"),
+			var("false", "0"),
+			var("is", "=="),
+			var("not", "!"),
+			var("or", "||"),
+			var("true", "1"),
+			var("xor", "^")
+		};
+
+		return vars;
+	}
+
+	// Function that brings interpreter back to the state right after construction
+	// Containers are cleared instead of being replaced, so their capacity is reused by the next script
+	void Interpreter::reset()
+	{
+		cancel();
+		flush();
+
+		vars = defaults();
+		error.clear();
+		filename.clear();
+		fname.clear();
+		sid = 0;
+		interned.clear();
+		output.clear();
+
+		functions = Functions();
+		dfunctions = Defined();
+
+		// Context is shared only with nested scopes, which do not exist anymore
+		context->handles = 0;
+		context->readers.clear();
+		context->writers.clear();
+		context->seeded = false; // Next job must not continue sequence seeded by previous one
+		*context->execution = Execution();
+		context->tail = deferred();
+		context->profiler.reset(); // Report of profiler is saved if it is not used by other interpreters
+		context->track.reset(); // Sampler drops track that is not used by any interpreter
+		context->stats.clear();
+		context->dump = nullptr;
+
+		sink.reset();
+		succeeded = false;
+
+		previous_action.clear();
+		action.clear();
+		lines.clear();
+		scope = 0;
+
+		line = 0;
+		returned.value.clear();
+		returned.type = Type::UNDEFINED;
+		continued = false;
+		broke = false;
+		log = false;
+		debug = false;
+		enabledIO = false;
+		enabledOutput = false;
+		cached = false;
+	}
+
+	void Interpreter::reset(const std::shared_ptr<const Image>& i)
+	{
+		reset();
+
+		vars = i->vars;
+		functions = i->functions;
+		dfunctions = i->dfunctions;
+	}
+
+	std::shared_ptr<const Image> Interpreter::snapshot() const
+	{
+		std::shared_ptr<Image> image = std::make_shared<Image>();
+		image->vars = vars;
+		image->functions = functions;
+		image->dfunctions = dfunctions;
+
+		return image;
+	}
+
+	const std::string& Interpreter::unit() const
+	{
+		static const std::string script("script");
+
+		if (fname != "") return fname;
+		if (filename != "") return filename;
+		return script;
+	}
+
+	unsigned int Interpreter::unitId(const std::string& u)
+	{
+		if (sid == 0 || interned != u)
+		{
+			sid = Sampler::global().intern(u);
+			interned = u;
+		}
+
+		return sid;
+	}
+
+	void Interpreter::enableProfiling(const std::string& p)
+	{
+		if (!context->profiler) context->profiler = std::make_shared<Profiler>(p);
+		else if (p != "") context->profiler->setPath(p);
+	}
+
+	// Started script that was not finished is aborted, so that its stack is unwound
+	Interpreter::~Interpreter()
+	{
+		cancel();
+	}
+
+	// Function that writes output to sink or std::cout (if IO is enabled)
+	void Interpreter::write(const char* s, const size_t& n)
+	{
+		if (!enabledIO) return;
+
+		if (sink) sink->write(s, n);
+		else std::cout.write(s, n);
+	}
+
+	void Interpreter::setSink(const std::shared_ptr<Sink>& s, const size_t& chunk)
+	{
+		flush();
+
+		if (s && chunk > 0) sink = std::make_shared<BufferedSink>(s, chunk);
+		else sink = s;
+	}
+
+	void Interpreter::flush()
+	{
+		if (sink) sink->flush();
+		else if (enabledIO) std::cout.flush();
+	}
+
 	// Function that checks for errors and logs them on console screen
 	// Return true or false based on whether it had any errors or not
 	bool Interpreter::errorLog()
@@ -55,13 +281,33 @@ namespace cll
 		var params("[]");
 		for (size_t i = 1; i < v.size(); ++i) params += v[i];
 
+		CLL_COUNT(interpreters, 1);
+
 		std::unique_ptr<Interpreter> nested = std::make_unique<Interpreter>();
 		nested->log = log;
 		nested->debug = debug;
 		nested->enabledIO = enabledIO;
+		nested->cached = cached;
+		nested->sink = sink;
+		nested->seed(context->generator()()); // Child script is reproducible if its parent is
+		nested->context->execution = context->execution; // Child script runs in the same fiber
+		nested->context->profiler = context->profiler;
+		nested->context->track = context->track;
 		nested->setVar("argv", params);
 
-		bool state = nested->readFile(v[1].getString());
+		std::string path = v[1].getString();
+		traceScope trace(Tracer::Category::SCRIPT, path);
+
+		// Compiled module is shared with every other 'include' and 'cll' statement of that file
+		std::shared_ptr<const compiled> module = getModule(path, version, cached);
+		bool state = false;
+
+		if (module)
+		{
+			nested->filename = path;
+			state = nested->readCompiled(*module);
+		}
+		else state = nested->readFile(path);
 		if (!state)
 		{
 			if (nested->line != 0) error = "Error in file '" + nested->filename + "' on line " + std::to_string(nested->line) + ":\n";
@@ -71,53 +317,326 @@ namespace cll
 	}
 
 	// Function that executes user defined functions along with passed parameters
-	// L parameter stands for lines defined in that function scope
+	// F parameter stands for function - its name and lines defined in its scope
 	// Args parameter stand for passed parameters in CLL
 	// Returns variable based on whether it returned anything by 'return' statement
-	var Interpreter::newFunction(const std::vector<var>& args, const std::vector<std::string>& l)
+	var Interpreter::newFunction(const defined& f, const std::vector<var>& args)
 	{
-		var params("[]");
+		// Pure function is not executed again for the same arguments
+		std::string key;
+		var ret;
+
+		if (f.memo != nullptr)
+		{
+			key = Memo::key(args);
+
+			if (f.memo->get(key, ret))
+			{
+				CLL_COUNT(memoized, 1);
+				return ret;
+			}
+		}
+
+		Execution& exec = *context->execution;
+
+		if (exec.limit > 0 && exec.depth >= exec.limit)
+		{
+			error = "Depth of calls of script (" + std::to_string(exec.limit) + ") exceeded!";
+			return var("0");
+		}
+
+		++exec.depth;
+
+		// Deep recursion continues on a new stack segment instead of overflowing native stack
+		char top; // Marks how deep actual stack is used
+		const char*& floor = Fiber::floor();
+		if (floor == nullptr) floor = &top - (Execution::segment - Execution::reserve); // Bounds of stack of thread are not known
+
+		if (uintptr_t(&top) < uintptr_t(floor) + Execution::reserve)
+		{
+			Fiber* outer = exec.stack;
+			Fiber segment([&]() { ret = execFunction(f, args); }, Execution::segment);
+
+			exec.stack = &segment;
+			bool started = segment.resume();
+
+			// Script was suspended inside of segment - it is suspended here too and segment continues when script is resumed
+			while (started && !segment.finished())
+			{
+				exec.stack = outer;
+				exec.yield();
+
+				exec.stack = &segment;
+				segment.resume();
+			}
+
+			exec.stack = outer;
+
+			if (!started)
+			{
+				error = "Stack for depth of calls " + std::to_string(exec.depth) + " could not be allocated!";
+				ret = var("0");
+			}
+		}
+		else ret = execFunction(f, args);
+
+		--exec.depth;
+
+		if (f.memo != nullptr && error == "") f.memo->put(key, ret);
+		return ret;
+	}
+
+	// Function that executes body of user defined function on actual stack
+	// Calls in tail position ('return f(...)') are executed here one after another instead of nesting
+	var Interpreter::execFunction(const defined& f, const std::vector<var>& args)
+	{
+		const std::string* name = &f.name;
+		const std::vector<var>* passed = &args;
+		const compiled* body = f.lines.get();
+		unsigned int id = f.id;
+
+		deferred tail; // Holds call that replaced this function
+		bool tailed = false;
+
+		while (true)
+		{
+			{
+				if (!step()) return var("0");
+
+				callProbe probe(context->profiling(), *name);
+				traceScope trace(Tracer::Category::FUNCTION, *name);
+				CLL_COUNT(calls, 1);
+
+				var params("[]");
+				for (size_t i = 0; i < passed->size(); ++i)
+				{
+					if ((*passed)[i].value != ",") params += (*passed)[i];
+				}
+
+				std::unique_ptr<Interpreter> nested(new Interpreter(context, defaults()));
+				nested->log = log;
+				nested->debug = debug;
+				nested->enabledIO = enabledIO;
+				nested->cached = cached;
+				nested->sink = sink;
+				nested->functions = functions;
+				nested->dfunctions = dfunctions;
+				nested->fname = *name;
+				nested->sid = id;
+				nested->setVar("argv", params);
+
+				Sampler::track* track = context->sampling();
+				sampledCall sampled(track, nested->sid);
+
+				for (size_t i = 0; i < body->size(); ++i)
+				{
+					nested->line = (unsigned int)i + 1;
+					lineProbe probe(context->profiling(), *name, nested->line);
+					if (track != nullptr) track->at(nested->sid, nested->line);
+
+					if (!nested->readTokens((*body)[i]))
+					{
+						error = nested->error;
+						return var("0");
+					}
+
+					if (nested->returned.value != "") break;
+				}
+
+				if (context->tail.lines == nullptr)
+				{
+					if (nested->returned.value != "") return nested->returned;
+					return var(tailed ? "1" : ""); // 'return f(...)' returns 1 if f returns nothing
+				}
+			}
+
+			// Called function replaces this one after its probes are closed
+			tail.name = std::move(context->tail.name);
+			tail.args = std::move(context->tail.args);
+			tail.lines = std::move(context->tail.lines);
+			tail.id = context->tail.id;
+			context->tail.lines.reset();
+
+			name = &tail.name;
+			passed = &tail.args;
+			body = tail.lines.get();
+			id = tail.id;
+			tailed = true;
+		}
+	}
+
+	// Function that leaves call of user defined function in 'return f(...)' statement to the function that returns it
+	// V parameter stands for token of the call
+	// Returns false if it is not a call of user defined function - then it is executed as usual
+	bool Interpreter::tailCall(const var& v)
+	{
+		std::string fun = v.value.substr(0, v.value.find("("));
+		// Pure function is called as usual, so that its result is memoized
+		defined dbuff = dfunctions.get(fun);
+		if (dbuff.name == "" || dbuff.memo != nullptr) return false;
+
+		std::vector<var> args = math(lexer(v.value.substr(fun.length() + 1, v.value.length() - fun.length() - 2)), false);
+		if (!parse({ v.value.substr(fun.length(), v.value.length() - fun.length()) }) || error != "") return true;
+
 		for (size_t i = 0; i < args.size(); ++i)
 		{
-			if (args[i].value != ",") params += args[i];
+			if (args[i].type == Type::UNDEFINED)
+			{
+				error = "Name '" + v.value + "' not recognized!";
+				return true;
+			}
 		}
 
-		std::unique_ptr<Interpreter> nested = std::make_unique<Interpreter>();
-		nested->log = log;
-		nested->debug = debug;
-		nested->enabledIO = enabledIO;
-		nested->functions = functions;
-		nested->dfunctions = dfunctions;
-		nested->setVar("argv", params);
+		context->tail.name = fun;
+		context->tail.args = std::move(args);
+		context->tail.lines = dbuff.lines;
+		context->tail.id = dbuff.id;
+		returned = var("1");
+
+		return true;
+	}
+
+	// Function that counts steps (loop iterations and function calls) and checks limits of script
+	// Script executed step by step is paused until host changes its limits, otherwise it is stopped
+	// Returns false (with an error) if script has to be stopped
+	bool Interpreter::step()
+	{
+		Execution& exec = *context->execution;
+		++exec.used;
+
+		while (exec.budget > 0 && exec.used > exec.budget)
+		{
+			if (exec.fiber == nullptr)
+			{
+				error = "Step budget of script (" + std::to_string(exec.budget) + ") exceeded!";
+				return false;
+			}
+
+			if (!exec.suspend(State::EXHAUSTED))
+			{
+				error = "Script was cancelled!";
+				return false;
+			}
+		}
+
+#ifdef CLL_STATS
+		if (context->dump && (exec.used & 63) == 0) dumpStats();
+#endif
+
+		// Clock is checked only every 64 steps, because it is much slower than counting
+		if (!exec.timed || (exec.used & 63) != 0) return true;
 
-		for (size_t i = 0; i < l.size(); ++i)
+		while (exec.timed && std::chrono::steady_clock::now() >= exec.deadline)
 		{
-			if (!nested->readLine(l[i]))
+			if (exec.fiber == nullptr)
 			{
-				error = nested->error;
-				return var("0");
+				error = "Deadline of script exceeded!";
+				return false;
+			}
+
+			if (!exec.suspend(State::EXPIRED))
+			{
+				error = "Script was cancelled!";
+				return false;
 			}
+		}
+
+		return true;
+	}
+
+	void Interpreter::dumpStats()
+	{
+		std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+		if (now < context->next) return;
+
+		context->next = now + context->interval;
+		context->dump(context->stats);
+	}
+
+	void Interpreter::setStatsDump(const std::function<void(const Stats&)>& f, const std::chrono::milliseconds& interval)
+	{
+		context->dump = f;
+		context->interval = interval;
+		context->next = std::chrono::steady_clock::now() + interval;
+	}
+
+	// Function that calls user defined function (or builtin one if there is no such function) like it was called in CLL
+	// Args parameter stands for values of arguments - commas between them are added here
+	var Interpreter::call(const std::string& n, const std::vector<var>& args)
+	{
+		statsGuard counting(context->stats);
+
+		std::vector<var> params;
+		params.reserve(args.size() * 2);
+
+		for (size_t i = 0; i < args.size(); ++i)
+		{
+			if (i != 0) params.emplace_back(",");
+			params.emplace_back(args[i]);
+		}
+
+		defined dbuff = dfunctions.get(n);
+		if (dbuff.name != "") return newFunction(dbuff, params);
 
-			if (nested->returned.value != "") return nested->returned;
+		function buff = functions.get(n);
+		if (buff.name != "")
+		{
+			CLL_COUNT(builtins, 1);
+			traceScope trace(Tracer::Category::BUILTIN, buff.name);
+			return buff.exec(*this, params);
 		}
 
-		return var("");
+		error = "Function '" + n + "' not recognized!";
+		return var("0");
+	}
+
+	// Function that creates interpreter which can run on another thread
+	// It shares nothing with this one - functions are copied, while context and sink are its own
+	// S parameter stands for its sink - it is used as is (without batching), std::cout is used if it is not set
+	std::unique_ptr<Interpreter> Interpreter::isolate(const std::shared_ptr<Sink>& s) const
+	{
+		CLL_COUNT(interpreters, 1);
+
+		std::unique_ptr<Interpreter> nested = std::make_unique<Interpreter>();
+		nested->debug = debug;
+		nested->filename = filename;
+		nested->enabledIO = enabledIO;
+		nested->cached = cached;
+		nested->sink = s;
+		nested->context->execution->timed = context->execution->timed; // Deadline applies also to work done on other threads
+		nested->context->execution->deadline = context->execution->deadline;
+		nested->context->execution->limit = context->execution->limit;
+		nested->functions = functions;
+		nested->dfunctions = dfunctions;
+
+		return nested;
 	}
 
 	// Function that creates new scope that has its own variables and also variables from one scope higher
 	// It also checks for loops conditions and executes accordingly
 	// Action parameter stands for tokens that have loop statement like so: while true
 	// ID parameter stands for id at which to look for condition. For 'while' it will be 1
-	bool Interpreter::newScope(const std::vector<std::string>& l, const std::vector<var>& action, const size_t& id)
+	bool Interpreter::newScope(const compiled& l, const std::vector<var>& action, const size_t& id)
 	{
-		std::unique_ptr<Interpreter> nested = std::make_unique<Interpreter>(vars);
+		std::unique_ptr<Interpreter> nested(new Interpreter(context, vars));
 		nested->log = log;
 		nested->debug = debug;
 		nested->filename = filename;
 		nested->enabledIO = enabledIO;
+		nested->cached = cached;
+		nested->sink = sink;
 		nested->functions = functions;
 		nested->dfunctions = dfunctions;
+		nested->fname = fname;
+		nested->sid = sid;
 		nested->line = (line >= (unsigned int)l.size()) ? (line - (unsigned int)l.size()) : 0;
+		CLL_COUNT(scopes, 1);
+
+		traceScope trace(Tracer::Category::SCOPE, (action[0].value == "1") ? unit() : action[0].value);
+
+		unsigned int first = nested->line; // Line number of the first line of scope
+		Profiler* profiler = context->profiling();
+		Sampler::track* track = context->sampling();
 		
 		bool condition = false; // Whether to execute a scope or not
 		bool state = true; // Is set to false when there is an error inside of scope
@@ -171,19 +690,28 @@ namespace cll
 				return false;
 			}
 
+			if (!step()) return false;
+
 			// EXECUTE A SCOPE
+			nested->line = first;
+
 			for (size_t i = 0; i < l.size(); ++i)
 			{
 				nested->continued = false;
 
-				if (!nested->readLine(l[i]))
 				{
-					error = nested->error;
-					line = nested->line;
-					return false;
+					lineProbe probe(profiler, nested->unit(), nested->line);
+					if (track != nullptr) track->at(nested->sid, nested->line);
+
+					if (!nested->readTokens(l[i]))
+					{
+						error = nested->error;
+						line = nested->line;
+						return false;
+					}
 				}
 
-				if (filename != "") nested->line++;
+				nested->line++;
 				if (nested->continued || nested->broke) break;
 				if (nested->returned.value != "")
 				{
@@ -292,10 +820,12 @@ namespace cll
 			}
 			else if (v[0].value == "function")
 			{
+				size_t id = (v.size() == 3 && v[1].value == "pure") ? 2 : 1; // 'function pure name'
+
 				if (v.size() < 2) error = "Statement 'function' got too few arguments!";
-				else if (v.size() > 2) error = "Statement 'function' got too many arguments!";
-				else if (v[1].type != Type::UNDEFINED) error = "Illegal name '" + v[1].value + "' after 'function' statement!";
-				else if (var(v[1].value, "").getError() != "") error = "Illegal name '" + v[1].value + "' after 'function' statement!";
+				else if (v.size() > id + 1) error = "Statement 'function' got too many arguments!";
+				else if (v[id].type != Type::UNDEFINED) error = "Illegal name '" + v[id].value + "' after 'function' statement!";
+				else if (var(v[id].value, "").getError() != "") error = "Illegal name '" + v[id].value + "' after 'function' statement!";
 			}
 			else if (v[0].value == "else")
 			{
@@ -439,22 +969,56 @@ namespace cll
 			{
 				for (size_t i = 1; i < v.size(); ++i)
 				{
-					if (v[i].type == Type::CHAR) write(std::string(1, char(v[i].getInt())));
-					else write(v[i].getString());
+					if (v[i].type == Type::CHAR)
+					{
+						char c = char(v[i].getInt());
+						write(&c, 1);
+					}
+					else if (v[i].type == Type::STRING) write(v[i].getString());
+					else write(v[i].value);
 				}
 			}
 			else if (enabledIO && v[0].value == "cin")
 			{
+				// Script executed step by step yields, so that host can wait for input without blocking
+				if (!context->execution->suspend(State::WAITING))
+				{
+					error = "Script was cancelled!";
+					return false;
+				}
+
+				flush(); // Prompt must be visible before waiting for input
+
 				for (size_t i = 1; i < v.size(); ++i)
 				{
+					std::string bname = (v[i].name != "") ? v[i].name : v[i].value;
+
+					// 'cin name[]' reads all remaining values of input into an array
+					if (bname.length() > 2 && bname.compare(bname.length() - 2, 2, "[]") == 0)
+					{
+						var arr;
+						arr.setName(bname.substr(0, bname.length() - 2));
+						arr.value.assign(1, '[');
+						readValues(std::cin.rdbuf(), arr.value);
+						arr.value += ']';
+						arr.type = Type::ARRAY;
+
+						if (!setVar(arr))
+						{
+							error = "Name '" + bname + "' not recognized!";
+							break;
+						}
+
+						continue;
+					}
+
 					std::string buff;
 					std::getline(std::cin, buff);
 					var test(buff);
 					if (test.type == Type::UNDEFINED || test.type == Type::BARE) buff = "\"" + buff + "\"";
 
-					if (!setVar((v[i].name != "") ? v[i].name : v[i].value, buff))
+					if (!setVar(bname, buff))
 					{
-						std::string bname = (v[i].name != "") ? v[i].name : v[i].value;
 						error = "Name '" + bname + "' not recognized!";
 						break;
 					}
@@ -477,21 +1041,29 @@ namespace cll
 			else if (v[0].value == "break") broke = true;
 			else if (v[0].value == "include")
 			{
-				std::fstream buff(v[1].getString(), std::ios::in);
-				std::string l;
+				std::string path = v[1].getString();
+				traceScope trace(Tracer::Category::INCLUDE, path);
 
-				if (buff.good())
+				std::shared_ptr<const compiled> module = getModule(path, version, cached);
+
+				if (module)
 				{
-					while (getline(buff, l))
+					for (size_t i = 0; i < module->size(); ++i)
 					{
-						if (!readLine(l)) return errorLog();
+						if (!readTokens((*module)[i])) return errorLog();
 					}
 				}
 				else error = "File '" + v[1].getString() + "' could not be included!";
 			}
 		}
 		else if (v[0].value == "{" && v[0].type == Type::SYMBOL) scope = 1;
-		else if (enabledOutput && v.size() == 1 && v[0].type != Type::UNDEFINED) output = v[0].value + " " + v[0].getType();
+		else if (enabledOutput && v.size() == 1 && v[0].type != Type::UNDEFINED) 
+		{
+			// Output capacity is reused between lines
+			output.assign(v[0].value);
+			output += ' ';
+			output += v[0].getType();
+		}
 
 		if (error != "") return false;
 		return true;
@@ -502,6 +1074,8 @@ namespace cll
 	// Returns processed tokens
 	std::vector<var> Interpreter::math(const std::vector<var>& v, const bool& comma)
 	{
+		CLL_COUNT(reductions, 1);
+
 		std::vector<var> vec;
 		vec.reserve(v.size());
 
@@ -572,13 +1146,15 @@ namespace cll
 				if (errflag) vec.emplace_back(v[i]);
 				else if (dbuff.name != "" && check)
 				{
-					var ret = newFunction(args, dbuff.lines);
+					var ret = newFunction(dbuff, args);
 					ret.name.clear();
 					if (ret.value != "") vec.emplace_back(ret);
 				}
 				else if (buff.name != "" && check)
 				{
-					var ret = buff.exec(args);
+					CLL_COUNT(builtins, 1);
+					traceScope trace(Tracer::Category::BUILTIN, buff.name);
+					var ret = buff.exec(*this, args);
 					ret.name.clear();
 					if (ret.value != "") vec.emplace_back(ret);
 				}
@@ -780,11 +1356,10 @@ namespace cll
 		if (v[0].value == "{" && v[0].type == Type::SYMBOL) ++scope;
 		if (v[0].value == "}" && v[0].type == Type::SYMBOL) --scope;
 
+		// Tokens are kept as they are, so scope is not tokenized again when it is executed
 		if (scope)
 		{
-			std::string buff("");
-			for (size_t i = 0; i < v.size(); ++i) buff += v[i].value + " ";
-			lines.emplace_back(buff);
+			lines.emplace_back(v);
 			return true;
 		}
 		else
@@ -794,7 +1369,12 @@ namespace cll
 			if (action.empty()) state = newScope(lines);
 			else if (action[0].value == "function")
 			{
-				dfunctions.add(defined((action[1].name != "") ? action[1].name : action[1].value, lines));
+				// Results of pure function are memoized
+				bool pure = action.size() > 2;
+				const var& n = action[pure ? 2 : 1];
+
+				const std::string& name = (n.name != "") ? n.name : n.value;
+				dfunctions.add(defined(name, std::make_shared<const compiled>(std::move(lines)), pure ? std::make_shared<Memo>() : nullptr, Sampler::global().intern(name)));
 			}
 			else if (action[0].value == "if" && action[1].getBool()) state = newScope(lines, action);
 			else if (action[0].value == "else")
@@ -822,13 +1402,35 @@ namespace cll
 	// Returns true or false based on whether it had any errors or not
 	bool Interpreter::readLine(const std::string& l)
 	{
+		statsGuard counting(context->stats);
+
 		// SEPARATES LINE BY ARGUMENTS
-		std::vector<var> args_line = lexer(l); // Holds raw line tokens
+		return readTokens(lexer(l));
+	}
+
+	// Function that interpretes one already tokenized line
+	// L parameter stands for raw line tokens
+	// Returns true or false based on whether it had any errors or not
+	bool Interpreter::readTokens(const std::vector<var>& args_line)
+	{
+		// YIELDS IF TIME SLICE OF SCRIPT EXECUTED STEP BY STEP IS USED UP
+		Execution& exec = *context->execution;
+
+		if (exec.fiber != nullptr && exec.slice > 0 && ++exec.steps >= exec.slice)
+		{
+			exec.steps = 0;
+
+			if (!exec.suspend(State::YIELDED))
+			{
+				error = "Script was cancelled!";
+				return errorLog();
+			}
+		}
 
 		// CHECKS FOR LINE BREAK (SEMICOLON) AND FOR BRACKETS
 		std::vector<var> args;
 		args.reserve(args_line.size());
-		std::string newline("");
+		std::vector<var> newline; // Holds tokens after line break - to be interpreted as next line
 		bool multiline = false;
 			
 		for (size_t i = 0; i < args_line.size(); ++i)
@@ -845,21 +1447,21 @@ namespace cll
 				}
 			}
 
-			if (multiline) newline += args_line[i].value + " ";
+			if (multiline) newline.emplace_back(args_line[i]);
 			else args.emplace_back(args_line[i]);
 		}
 
 		if (!action.empty() && !scope && args[0].value != "{")
 		{
 			scope = 1;
-			newline += "}";
+			newline.emplace_back("}");
 		}
 
 		if (args.empty())
 		{
-			if (scope) lines.emplace_back("");
+			if (scope) lines.emplace_back();
 
-			if (!args_line.empty() && !readLine(newline)) return errorLog();
+			if (!args_line.empty() && !readTokens(newline)) return errorLog();
 			return true;
 		}
 
@@ -867,7 +1469,7 @@ namespace cll
 		if (scope)
 		{
 			if (!readScope(args)) return errorLog();
-			if (newline != "" && !readLine(newline)) return errorLog();
+			if (!newline.empty() && !readTokens(newline)) return errorLog();
 			return true;
 		} 
 
@@ -888,6 +1490,9 @@ namespace cll
 		// PARSER
 		if (!parse(args)) return errorLog();
 
+		// CALL IN TAIL POSITION OF USER DEFINED FUNCTION - it is executed by that function, so that recursion does not nest
+		if (fname != "" && args.size() == 2 && args[0].type == Type::BARE && args[0].value == "return" && args[1].type == Type::UNDEFINED && args[1].isFunction() && tailCall(args[1])) return errorLog();
+
 		// APPLIES MATH TO TOKENS
 		if (!(args[0].value == "do" || args[0].value == "while" || args[0].value == "for")) args = math(args);
 
@@ -915,7 +1520,7 @@ namespace cll
 
 		if (!bare(args)) return errorLog();
 
-		if (newline != "" && !readLine(newline)) return errorLog();
+		if (!newline.empty() && !readTokens(newline)) return errorLog();
 		return true;
 	}
 
@@ -945,8 +1550,20 @@ namespace cll
 	// Function that interpretes whole vector line by line
 	bool Interpreter::readVector(const std::vector<std::string>& v)
 	{
+		flusher guard = { *this };
+		statsGuard counting(context->stats);
+		callProbe frame(context->profiling(), unit());
+
+		Sampler::track* track = context->sampling();
+		if (track != nullptr) unitId(unit());
+		sampling sampled(track);
+
 		for (size_t i = 0; i < v.size(); ++i)
 		{
+			line = (unsigned int)i + 1;
+			lineProbe probe(context->profiling(), unit(), line);
+			if (track != nullptr) track->at(sid, line);
+
 			if (!readLine(v[i]))
 			{
 				if (error != "") return false;
@@ -955,37 +1572,191 @@ namespace cll
 			}
 		}
 
+		line = 0;
+
 		return errorLog();
 	}
 
+	// STEP BY STEP EXECUTION //
+
+	bool Interpreter::start(const std::function<bool()>& f, const size_t& stack)
+	{
+		if (task) return false;
+
+		succeeded = false;
+		task.reset(new Fiber([this, f]() { succeeded = f(); }, stack));
+
+		if (!task->good())
+		{
+			task.reset();
+			error = "Stack of script could not be allocated!";
+			return false;
+		}
+
+		return true;
+	}
+
+	bool Interpreter::startFile(const std::string& f, const size_t& stack)
+	{
+		return start([this, f]() { return readFile(f); }, stack);
+	}
+
+	bool Interpreter::startVector(const std::vector<std::string>& v, const size_t& stack)
+	{
+		return start([this, v]() { return readVector(v); }, stack);
+	}
+
+	bool Interpreter::startProgram(const Program& p, const size_t& stack)
+	{
+		return start([this, p]() { return run(p); }, stack);
+	}
+
+	// Function that executes started script until it yields
+	// Returns reason of suspension or whether script finished with or without errors
+	State Interpreter::resume()
+	{
+		if (!task) return State::FINISHED;
+
+		// Fiber is visible to yielding points only while script runs
+		Execution& exec = *context->execution;
+		exec.fiber = task.get();
+		exec.steps = 0;
+
+		statsGuard counting(context->stats, true);
+
+		task->resume();
+		exec.fiber = nullptr;
+
+		if (!task->finished()) return exec.state;
+
+		task.reset();
+		return (succeeded) ? State::FINISHED : State::FAILED;
+	}
+
+	// Function that aborts started script
+	// Suspended script is resumed with cancelled flag, so every yielding point fails and script unwinds with an error
+	void Interpreter::cancel()
+	{
+		if (!task) return;
+
+		Execution& exec = *context->execution;
+
+		if (task->started())
+		{
+			exec.cancelled = true;
+			exec.fiber = task.get();
+
+			while (!task->finished()) task->resume();
+
+			exec.fiber = nullptr;
+			exec.cancelled = false;
+		}
+
+		task.reset();
+	}
+
 	// Function that interpretes whole file line by line
 	bool Interpreter::readFile(const std::string& f)
 	{
+		flusher guard = { *this };
+		statsGuard counting(context->stats);
+
 		filename = f;
 
-		std::fstream file(filename, std::ios::in);
-		std::string l("");
+		if (cached)
+		{
+			compiled c;
+			if (compile(filename, c, version, true)) return readCompiled(c);
+
+			error = "File '" + f + "' could not be opened!";
+			filename.clear();
+
+			return errorLog();
+		}
+
+		// Lines are tokenized straight from mapped memory, without copying them
+		MappedFile file(filename);
 
 		if (file.good())
 		{
-			while (std::getline(file, l))
+			callProbe frame(context->profiling(), filename);
+
+			Sampler::track* track = context->sampling();
+			if (track != nullptr) unitId(filename);
+			sampling sampled(track);
+
+			const char* it = file.data();
+			const char* end = it + file.size();
+
+			while (it < end)
 			{
+				const char* nl = static_cast<const char*>(std::memchr(it, '\n', end - it));
+				if (nl == nullptr) nl = end;
+
 				line++;
-				if (!readLine(l))
-				{
-					file.close();
+				lineProbe probe(context->profiling(), filename, line);
+				if (track != nullptr) track->at(sid, line);
 
+				if (!readTokens(lexer(it, nl)))
+				{
 					if (error != "") return false;
 					else if (returned.value == "") return true;
 					else return false;
 				}
+
+				it = nl + 1;
 			}
 		}
 		else error = "File '" + f + "' could not be opened!";
 
 		line = 0;
 		filename.clear();
-		file.close();
+
+		return errorLog();
+	}
+
+	// Function that executes program - its tokens are shared with every other interpreter that runs it
+	bool Interpreter::run(const Program& p)
+	{
+		flusher guard = { *this };
+		statsGuard counting(context->stats);
+
+		if (!p.good())
+		{
+			error = p.getError();
+			return errorLog();
+		}
+
+		filename = p.getFilename();
+
+		return readCompiled(p.getTokens());
+	}
+
+	// Function that interpretes compiled script line by line
+	bool Interpreter::readCompiled(const compiled& c)
+	{
+		callProbe frame(context->profiling(), unit());
+
+		Sampler::track* track = context->sampling();
+		if (track != nullptr) unitId(unit());
+		sampling sampled(track);
+
+		for (size_t i = 0; i < c.size(); ++i)
+		{
+			line++;
+			lineProbe probe(context->profiling(), unit(), line);
+			if (track != nullptr) track->at(sid, line);
+
+			if (!readTokens(c[i]))
+			{
+				if (error != "") return false;
+				else if (returned.value == "") return true;
+				else return false;
+			}
+		}
+
+		line = 0;
+		filename.clear();
 
 		return errorLog();
 	}
@@ -993,6 +1764,8 @@ namespace cll
 	// Function that returns declared var by it's name - or 'undefined' if var is not declared
 	var Interpreter::getVar(const std::string& n)
 	{
+		CLL_COUNT(lookups, 1);
+
 		if (n.length() > 1 && n.find_first_of("[]") != std::string::npos)
 		{
 			if (n[n.length() - 1] == ']')
@@ -1039,12 +1812,16 @@ namespace cll
 
 		size_t index = search(vars, n, 0, vars.size() - 1);
 		if (index < vars.size()) return vars[index];
-		else return var(n, "");
+
+		CLL_COUNT(misses, 1);
+		return var(n, "");
 	}
 
 	// Function that changes defined var value or creates new var if one does not exist
 	bool Interpreter::setVar(const var& v)
 	{
+		CLL_COUNT(assignments, 1);
+
 		var ins = v;
 
 		if (v.name.length() > 1 && v.name.find_first_of("[]") != std::string::npos)
@@ -1075,8 +1852,24 @@ namespace cll
 		if (ins.getError() != "" || ins.name == "") return false;
 
 		size_t index = search(vars, ins.name, 0, vars.size() - 1);
-		if (index < vars.size()) vars[index] = ins;
-		else if (ins.name != "") vars.insert(std::upper_bound(vars.begin(), vars.end(), ins, [](var a, var b) { return a.name < b.name; }), ins);
+		if (index < vars.size())
+		{
+#ifdef CLL_STATS
+			size_t capacity = vars[index].value.capacity();
+			vars[index] = ins;
+
+			// Value reuses buffer of previous one, unless it does not fit into it
+			if (vars[index].value.capacity() > capacity) CLL_COUNT(bytes, Stats::heap(vars[index].value));
+#else
+			vars[index] = ins;
+#endif
+		}
+		else if (ins.name != "")
+		{
+			CLL_COUNT(insertions, 1);
+			CLL_COUNT(bytes, Stats::heap(ins.value));
+			vars.insert(std::upper_bound(vars.begin(), vars.end(), ins, [](var a, var b) { return a.name < b.name; }), ins);
+		}
 		else return false;
 
 		return true;
@@ -3,10 +3,16 @@
 // Author: Bartosz Niciak
 
 #include "static.hpp"
+#include "stats.hpp"
 
 namespace cll
 {
 	std::vector<var> lexer(const std::string& l)
+	{
+		return lexer(l.data(), l.data() + l.length());
+	}
+
+	std::vector<var> lexer(const char* begin, const char* end)
 	{
 		std::vector<var> args; // Holds vars (token) list
 		std::string buff(""); // Holds token in buffor before pushing it to token list
@@ -24,20 +30,20 @@ namespace cll
 		buff.reserve(25);
 		mult.reserve(3);
 
-		for (auto it = l.begin(), end = l.end(); it < end; ++it)
+		for (const char* it = begin; it < end; ++it)
 		{
 			// CHECKS FOR STRINGS
 			if (!chars && string && *it == '"')
 			{
-				if (it != l.begin() && *(it - 1) != '\\') string = false;
-				else if (it - 1 != l.begin() && *(it - 2) == '\\') string = false;
+				if (it != begin && *(it - 1) != '\\') string = false;
+				else if (it - 1 != begin && *(it - 2) == '\\') string = false;
 			}
 			else if (!chars && !string && *it == '"') string = true;
 			
 			if (!string && chars && *it == '\'')
 			{
-				if (it != l.begin() && *(it - 1) != '\\') chars = false;
-				else if (it - 1 != l.begin() && *(it - 2) == '\\') chars = false;
+				if (it != begin && *(it - 1) != '\\') chars = false;
+				else if (it - 1 != begin && *(it - 2) == '\\') chars = false;
 			}
 			else if (!string && !chars && *it == '\'') chars = true;
 
@@ -124,6 +130,15 @@ namespace cll
 		if (buff != "") args.emplace_back(buff);
 		if (special != "") args.emplace_back(special);
 
+#ifdef CLL_STATS
+		if (Stats* s = Stats::active())
+		{
+			++s->lines;
+			s->tokens += args.size();
+			for (size_t i = 0; i < args.size(); ++i) s->bytes += Stats::heap(args[i].value);
+		}
+#endif
+
 		return args;
 	}
 }
\ No newline at end of file
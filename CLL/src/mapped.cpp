@@ -0,0 +1,122 @@
+#include "mapped.hpp"
+
+// Author: Bartosz Niciak
+
+#include <fstream>
+
+#ifdef _WIN32
+
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+namespace cll
+{
+	// Function that maps file into memory or, when that is not possible, reads it into a buffer
+	// Returns true or false based on whether file could be opened or not
+	bool MappedFile::open(const std::string& f)
+	{
+		close();
+
+#ifdef _WIN32
+		HANDLE file = CreateFileA(f.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+
+		if (file != INVALID_HANDLE_VALUE)
+		{
+			LARGE_INTEGER siz;
+
+			if (GetFileType(file) == FILE_TYPE_DISK && GetFileSizeEx(file, &siz))
+			{
+				length = size_t(siz.QuadPart);
+				opened = true;
+
+				if (length != 0)
+				{
+					HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+					if (mapping != nullptr)
+					{
+						view = static_cast<const char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+						mapped = (view != nullptr);
+						CloseHandle(mapping);
+					}
+				}
+			}
+
+			CloseHandle(file);
+			if (mapped || (opened && length == 0)) return true;
+		}
+#else
+		int fd = ::open(f.c_str(), O_RDONLY);
+
+		if (fd != -1)
+		{
+			struct stat st;
+
+			if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+			{
+				length = size_t(st.st_size);
+				opened = true;
+
+				if (length != 0)
+				{
+					void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+					if (addr != MAP_FAILED)
+					{
+						view = static_cast<const char*>(addr);
+						mapped = true;
+					}
+				}
+			}
+
+			::close(fd);
+			if (mapped || (opened && length == 0)) return true;
+		}
+#endif
+
+		// FALLBACK - BUFFERED READ
+		length = 0;
+		opened = false;
+
+		std::ifstream file(f, std::ios::in | std::ios::binary);
+		if (!file.good()) return false;
+
+		char chunk[65536];
+
+		while (file.read(chunk, sizeof(chunk)) || file.gcount() > 0)
+		{
+			buffer.insert(buffer.end(), chunk, chunk + file.gcount());
+		}
+
+		view = buffer.data();
+		length = buffer.size();
+		opened = true;
+
+		return true;
+	}
+
+	// Function that unmaps file and frees its buffer
+	void MappedFile::close()
+	{
+#ifdef _WIN32
+		if (mapped) UnmapViewOfFile(view);
+#else
+		if (mapped) munmap(const_cast<char*>(view), length);
+#endif
+
+		buffer.clear();
+		view = nullptr;
+		length = 0;
+		mapped = false;
+		opened = false;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "memo.hpp"
+
+// Author: Bartosz Niciak
+
+namespace cll
+{
+	// Values are prefixed by their length, so that values with commas can not be confused with more arguments
+	std::string Memo::key(const std::vector<var>& args)
+	{
+		std::string k;
+
+		for (size_t i = 0; i < args.size(); ++i)
+		{
+			if (args[i].value == ",") continue;
+
+			k += std::to_string(args[i].value.length());
+			k += ':';
+			k += args[i].value;
+		}
+
+		return k;
+	}
+
+	bool Memo::get(const std::string& k, var& v)
+	{
+		std::lock_guard<std::mutex> lock(m);
+
+		auto it = index.find(k);
+		if (it == index.end())
+		{
+			++misses;
+			return false;
+		}
+
+		results.splice(results.begin(), results, it->second);
+		v = it->second->second;
+		++hits;
+
+		return true;
+	}
+
+	void Memo::put(const std::string& k, const var& v)
+	{
+		std::lock_guard<std::mutex> lock(m);
+		if (capacity == 0) return;
+
+		// Other thread could compute the same result in the meantime
+		auto it = index.find(k);
+		if (it != index.end())
+		{
+			it->second->second = v;
+			results.splice(results.begin(), results, it->second);
+			return;
+		}
+
+		if (results.size() >= capacity)
+		{
+			index.erase(results.back().first);
+			results.pop_back();
+			++evictions;
+		}
+
+		results.emplace_front(k, v);
+		index.emplace(k, results.begin());
+	}
+
+	void Memo::clear()
+	{
+		std::lock_guard<std::mutex> lock(m);
+
+		results.clear();
+		index.clear();
+		hits = 0;
+		misses = 0;
+		evictions = 0;
+	}
+
+	Memo::counters Memo::stats() const
+	{
+		std::lock_guard<std::mutex> lock(m);
+		return { hits, misses, evictions, results.size() };
+	}
+}
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "modules.hpp"
+
+// Author: Bartosz Niciak
+
+#include <cstdlib>
+#include <map>
+#include <mutex>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <limits.h>
+#endif
+
+namespace cll
+{
+	// Struct that holds compiled module along with state of file it was compiled from
+	struct module
+	{
+		long long mtime; // Modification time of file (in nanoseconds if platform supports it)
+		long long size; // Size of file
+		std::string version; // Interpreter version module was compiled by
+		std::shared_ptr<const compiled> code;
+	};
+
+	static std::mutex& modulesMutex()
+	{
+		static std::mutex m;
+		return m;
+	}
+
+	static std::map<std::string, module>& modules()
+	{
+		static std::map<std::string, module> m;
+		return m;
+	}
+
+	// Returns canonical path of a file, or unchanged path if it can not be resolved
+	static std::string canonical(const std::string& f)
+	{
+#ifdef _WIN32
+		char buff[_MAX_PATH];
+		if (_fullpath(buff, f.c_str(), _MAX_PATH) != nullptr) return buff;
+#else
+		char buff[PATH_MAX];
+		if (realpath(f.c_str(), buff) != nullptr) return buff;
+#endif
+		return f;
+	}
+
+	// Reads modification time and size of a file
+	// Returns false if file does not exist
+	static bool state(const std::string& f, long long& mtime, long long& size)
+	{
+		struct stat st;
+		if (stat(f.c_str(), &st) != 0) return false;
+
+#if defined(__linux__)
+		mtime = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+#else
+		mtime = (long long)st.st_mtime;
+#endif
+		size = (long long)st.st_size;
+		return true;
+	}
+
+	std::shared_ptr<const compiled> getModule(const std::string& f, const std::string& version, const bool& cache)
+	{
+		std::string path = canonical(f);
+		long long mtime = 0, size = 0;
+
+		if (!state(path, mtime, size)) return nullptr;
+
+		{
+			std::lock_guard<std::mutex> lock(modulesMutex());
+
+			auto it = modules().find(path);
+			if (it != modules().end() && it->second.mtime == mtime && it->second.size == size && it->second.version == version) return it->second.code;
+		}
+
+		// Module is compiled outside of the lock, so that other threads are not blocked by it
+		std::shared_ptr<compiled> code = std::make_shared<compiled>();
+		if (!compile(path, *code, version, cache)) return nullptr;
+
+		std::lock_guard<std::mutex> lock(modulesMutex());
+		modules()[path] = { mtime, size, version, code };
+
+		return code;
+	}
+
+	void invalidateModule(const std::string& f)
+	{
+		std::string path = canonical(f);
+
+		std::lock_guard<std::mutex> lock(modulesMutex());
+		modules().erase(path);
+	}
+
+	void clearModules()
+	{
+		std::lock_guard<std::mutex> lock(modulesMutex());
+		modules().clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "pool.hpp"
+
+// Author: Bartosz Niciak
+
+namespace cll
+{
+	std::unique_ptr<Interpreter> Pool::acquire()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m);
+
+			if (!free.empty())
+			{
+				std::unique_ptr<Interpreter> ret = std::move(free.back());
+				free.pop_back();
+				return ret;
+			}
+		}
+
+		if (image) return std::make_unique<Interpreter>(image);
+		return std::make_unique<Interpreter>();
+	}
+
+	void Pool::release(std::unique_ptr<Interpreter> i)
+	{
+		if (!i) return;
+
+		// Interpreter is reset outside of the lock, so that other threads are not blocked by it
+		if (image) i->reset(image);
+		else i->reset();
+
+		std::lock_guard<std::mutex> lock(m);
+		if (free.size() < limit) free.emplace_back(std::move(i));
+	}
+
+	void Pool::reserve(const size_t& n)
+	{
+		std::lock_guard<std::mutex> lock(m);
+
+		while (free.size() < n && free.size() < limit)
+		{
+			if (image) free.emplace_back(std::make_unique<Interpreter>(image));
+			else free.emplace_back(std::make_unique<Interpreter>());
+		}
+	}
+
+	size_t Pool::size()
+	{
+		std::lock_guard<std::mutex> lock(m);
+		return free.size();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "profiler.hpp"
+
+// Author: Bartosz Niciak
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+namespace cll
+{
+	// Returns duration in given unit with three decimal places
+	static std::string format(const Profiler::clock::duration& d, const double& unit)
+	{
+		char buff[32];
+		std::snprintf(buff, sizeof(buff), "%.3f", std::chrono::duration<double>(d).count() / unit);
+		return buff;
+	}
+
+	// Returns string padded with spaces from the left to given width
+	static std::string pad(const std::string& s, const size_t& width)
+	{
+		if (s.length() >= width) return s;
+		return std::string(width - s.length(), ' ') + s;
+	}
+
+	Profiler::~Profiler()
+	{
+		if (path != "") save(path);
+	}
+
+	void Profiler::addLine(const std::string& unit, const unsigned int& line, const clock::duration& d)
+	{
+		auto it = ids.find(unit);
+
+		if (it == ids.end())
+		{
+			it = ids.emplace(unit, units.size()).first;
+			units.emplace_back(unit);
+		}
+
+		record& r = lines[(static_cast<unsigned long long>(it->second) << 32) | line];
+		++r.count;
+		r.time += d;
+	}
+
+	size_t Profiler::enter(const std::string& name)
+	{
+		size_t n = 0;
+		std::vector<size_t>& children = nodes[current].children;
+
+		for (size_t i = 0; i < children.size(); ++i)
+		{
+			if (nodes[children[i]].name == name)
+			{
+				n = children[i];
+				break;
+			}
+		}
+
+		if (n == 0)
+		{
+			n = nodes.size();
+			nodes[current].children.emplace_back(n);
+			nodes.emplace_back(node{ name, current, 0, clock::duration::zero(), {} });
+		}
+
+		++nodes[n].count;
+		current = n;
+
+		return n;
+	}
+
+	void Profiler::leave(const size_t& n, const clock::duration& d)
+	{
+		nodes[n].time += d;
+		current = nodes[n].parent;
+	}
+
+	void Profiler::clear()
+	{
+		ids.clear();
+		units.clear();
+		lines.clear();
+		nodes.resize(1);
+		nodes[0].children.clear();
+		current = 0;
+	}
+
+	std::string Profiler::flat() const
+	{
+		std::string out;
+
+		// LINES - SORTED BY THEIR TOTAL TIME
+		std::vector<std::pair<unsigned long long, record>> sorted(lines.begin(), lines.end());
+		std::sort(sorted.begin(), sorted.end(), [](const std::pair<unsigned long long, record>& a, const std::pair<unsigned long long, record>& b)
+		{
+			return a.second.time > b.second.time;
+		});
+
+		out += "Lines:\n";
+		out += pad("count", 12) + pad("total [ms]", 16) + pad("average [us]", 16) + "   line\n";
+
+		for (size_t i = 0; i < sorted.size(); ++i)
+		{
+			const record& r = sorted[i].second;
+
+			out += pad(std::to_string(r.count), 12);
+			out += pad(format(r.time, 1e-3), 16);
+			out += pad(format(r.time / r.count, 1e-6), 16);
+			out += "   " + units[sorted[i].first >> 32] + ":" + std::to_string(sorted[i].first & 0xFFFFFFFF) + "\n";
+		}
+
+		// FUNCTIONS - AGGREGATED FROM CALL TREE
+		// Total time of recursive function is counted only at its outermost call
+		std::map<std::string, record> totals;
+		std::map<std::string, clock::duration> selfs;
+
+		for (size_t i = 1; i < nodes.size(); ++i)
+		{
+			clock::duration self = nodes[i].time;
+			for (size_t j = 0; j < nodes[i].children.size(); ++j) self -= nodes[nodes[i].children[j]].time;
+
+			bool outermost = true;
+			for (size_t p = nodes[i].parent; p != 0 && outermost; p = nodes[p].parent) outermost = nodes[p].name != nodes[i].name;
+
+			record& r = totals[nodes[i].name];
+			r.count += nodes[i].count;
+			if (outermost) r.time += nodes[i].time;
+
+			selfs[nodes[i].name] += self;
+		}
+
+		std::vector<std::pair<std::string, record>> functions(totals.begin(), totals.end());
+		std::sort(functions.begin(), functions.end(), [](const std::pair<std::string, record>& a, const std::pair<std::string, record>& b)
+		{
+			return a.second.time > b.second.time;
+		});
+
+		out += "\nFunctions:\n";
+		out += pad("calls", 12) + pad("total [ms]", 16) + pad("self [ms]", 16) + "   function\n";
+
+		for (size_t i = 0; i < functions.size(); ++i)
+		{
+			out += pad(std::to_string(functions[i].second.count), 12);
+			out += pad(format(functions[i].second.time, 1e-3), 16);
+			out += pad(format(selfs[functions[i].first], 1e-3), 16);
+			out += "   " + functions[i].first + "\n";
+		}
+
+		return out;
+	}
+
+	void Profiler::print(const size_t& n, const size_t& depth, std::string& out) const
+	{
+		out += pad(std::to_string(nodes[n].count), 12);
+		out += pad(format(nodes[n].time, 1e-3), 16);
+		out += "   " + std::string(depth * 2, ' ') + nodes[n].name + "\n";
+
+		for (size_t i = 0; i < nodes[n].children.size(); ++i) print(nodes[n].children[i], depth + 1, out);
+	}
+
+	std::string Profiler::tree() const
+	{
+		std::string out = "Call tree:\n";
+		out += pad("calls", 12) + pad("total [ms]", 16) + "   function\n";
+
+		for (size_t i = 0; i < nodes[0].children.size(); ++i) print(nodes[0].children[i], 0, out);
+
+		return out;
+	}
+
+	void Profiler::flatten(const size_t& n, std::string& prefix, std::string& out) const
+	{
+		size_t length = prefix.length();
+		if (!prefix.empty()) prefix += ";";
+		prefix += nodes[n].name;
+
+		clock::duration self = nodes[n].time;
+		for (size_t i = 0; i < nodes[n].children.size(); ++i) self -= nodes[nodes[n].children[i]].time;
+
+		long long us = std::chrono::duration_cast<std::chrono::microseconds>(self).count();
+		if (us > 0) out += prefix + " " + std::to_string(us) + "\n";
+
+		for (size_t i = 0; i < nodes[n].children.size(); ++i) flatten(nodes[n].children[i], prefix, out);
+
+		prefix.resize(length);
+	}
+
+	std::string Profiler::collapsed() const
+	{
+		std::string out;
+		std::string prefix;
+
+		for (size_t i = 0; i < nodes[0].children.size(); ++i) flatten(nodes[0].children[i], prefix, out);
+
+		return out;
+	}
+
+	bool Profiler::save(const std::string& p) const
+	{
+		std::ofstream report(p, std::ios::out | std::ios::trunc);
+		if (!report.good()) return false;
+
+		report << flat() << '\n' << tree();
+
+		std::ofstream folded(p + ".folded", std::ios::out | std::ios::trunc);
+		if (!folded.good()) return false;
+
+		folded << collapsed();
+
+		return report.good() && folded.good();
+	}
+}
\ No newline at end of file
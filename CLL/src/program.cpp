@@ -0,0 +1,45 @@
+#include "program.hpp"
+
+// Author: Bartosz Niciak
+
+#include "lexer.hpp"
+
+namespace cll
+{
+	Program Program::fromFile(const std::string& f)
+	{
+		Program p;
+		std::shared_ptr<compiled> c = std::make_shared<compiled>();
+
+		p.filename = f;
+
+		if (compile(f, *c, "", false)) p.tokens = c;
+		else p.error = "File '" + f + "' could not be opened!";
+
+		return p;
+	}
+
+	Program Program::fromString(const std::string& s)
+	{
+		Program p;
+		std::shared_ptr<compiled> c = std::make_shared<compiled>();
+
+		compile(s.data(), s.length(), *c);
+		p.tokens = c;
+
+		return p;
+	}
+
+	Program Program::fromVector(const std::vector<std::string>& v)
+	{
+		Program p;
+		std::shared_ptr<compiled> c = std::make_shared<compiled>();
+
+		c->reserve(v.size());
+		for (size_t i = 0; i < v.size(); ++i) c->emplace_back(lexer(v[i]));
+
+		p.tokens = c;
+
+		return p;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "sampler.hpp"
+
+// Author: Bartosz Niciak
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+namespace cll
+{
+	const size_t Sampler::depth;
+
+	Sampler& Sampler::global()
+	{
+		static Sampler sampler;
+		return sampler;
+	}
+
+	void Sampler::start(const std::chrono::microseconds& i)
+	{
+		stop();
+
+		std::lock_guard<std::mutex> lock(m);
+		interval = std::max(i, std::chrono::microseconds(1));
+		stopped = false;
+		worker = std::thread(&Sampler::work, this);
+	}
+
+	void Sampler::stop()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m);
+			stopped = true;
+		}
+
+		cv.notify_all();
+		if (worker.joinable()) worker.join();
+	}
+
+	void Sampler::clear()
+	{
+		std::lock_guard<std::mutex> lock(m);
+		lines.clear();
+		stacks.clear();
+		samples = 0;
+	}
+
+	void Sampler::work()
+	{
+		std::unique_lock<std::mutex> lock(m);
+
+		while (!cv.wait_for(lock, interval, [this]() { return stopped; })) sample();
+	}
+
+	// Track that is held only by sampler was released by its interpreters - called with locked mutex
+	void Sampler::prune()
+	{
+		for (size_t i = 0; i < tracks.size(); ++i)
+		{
+			if (tracks[i].use_count() == 1)
+			{
+				tracks[i] = tracks.back();
+				tracks.pop_back();
+				--i;
+			}
+		}
+	}
+
+	// Released tracks are dropped also here, because sample() does not run while sampler is stopped
+	std::shared_ptr<Sampler::track> Sampler::attach()
+	{
+		std::lock_guard<std::mutex> lock(m);
+		prune();
+		tracks.emplace_back(std::make_shared<track>());
+
+		return tracks.back();
+	}
+
+	unsigned int Sampler::intern(const std::string& n)
+	{
+		std::lock_guard<std::mutex> lock(interning);
+		auto it = ids.find(n);
+
+		if (it != ids.end()) return it->second;
+
+		ids.emplace(n, (unsigned int)names.size());
+		names.emplace_back(n);
+
+		return (unsigned int)names.size() - 1;
+	}
+
+	// Called by worker with locked mutex
+	void Sampler::sample()
+	{
+		std::vector<unsigned long long> stack;
+		prune();
+
+		for (size_t i = 0; i < tracks.size(); ++i)
+		{
+			track& t = *tracks[i];
+			if (t.running.load(std::memory_order_relaxed) <= 0) continue;
+
+			size_t frames = std::min(t.frames.load(std::memory_order_acquire), depth);
+			unsigned long long p = t.position.load(std::memory_order_relaxed);
+			if (p == 0) continue; // Script did not reach its first line yet
+
+			stack.clear();
+			for (size_t ii = 0; ii < frames; ++ii) stack.emplace_back(t.stack[ii].load(std::memory_order_relaxed));
+			stack.emplace_back(p);
+
+			++lines[p];
+			++stacks[stack];
+			++samples;
+		}
+	}
+
+	std::string Sampler::position(const unsigned long long& p) const
+	{
+		return name(p >> 32) + ":" + std::to_string(p & 0xFFFFFFFF);
+	}
+
+	std::string Sampler::name(const unsigned long long& u) const
+	{
+		return (u < names.size()) ? names[size_t(u)] : std::string("?");
+	}
+
+	std::string Sampler::report()
+	{
+		std::lock_guard<std::mutex> lock(m);
+		std::lock_guard<std::mutex> named(interning);
+
+		std::string out;
+		char buff[64];
+
+		// HOT LINES
+		std::vector<std::pair<unsigned long long, size_t>> hot(lines.begin(), lines.end());
+		std::sort(hot.begin(), hot.end(), [](const std::pair<unsigned long long, size_t>& a, const std::pair<unsigned long long, size_t>& b)
+		{
+			return a.second > b.second;
+		});
+
+		out += "Samples: " + std::to_string(samples) + "\n\nLines:\n";
+		std::snprintf(buff, sizeof(buff), "%12s %10s   %s\n", "samples", "percent", "line");
+		out += buff;
+
+		for (size_t i = 0; i < hot.size(); ++i)
+		{
+			std::snprintf(buff, sizeof(buff), "%12zu %9.2f%%   ", hot[i].second, 100.0 * double(hot[i].second) / double(samples));
+			out += buff + position(hot[i].first) + "\n";
+		}
+
+		// FUNCTIONS - self samples are those in which function is on top of the stack
+		std::map<unsigned long long, std::pair<size_t, size_t>> functions; // Self and total samples by unit id
+
+		for (auto it = stacks.begin(); it != stacks.end(); ++it)
+		{
+			const std::vector<unsigned long long>& s = it->first;
+
+			for (size_t i = 0; i + 1 < s.size(); ++i)
+			{
+				// Recursive function is counted once per sample
+				if (std::find(s.begin(), s.begin() + i, s[i]) == s.begin() + i) functions[s[i]].second += it->second;
+			}
+
+			if (s.size() > 1) functions[s[s.size() - 2]].first += it->second;
+		}
+
+		std::vector<std::pair<unsigned long long, std::pair<size_t, size_t>>> sorted(functions.begin(), functions.end());
+		std::sort(sorted.begin(), sorted.end(), [](const std::pair<unsigned long long, std::pair<size_t, size_t>>& a, const std::pair<unsigned long long, std::pair<size_t, size_t>>& b)
+		{
+			return a.second.second > b.second.second;
+		});
+
+		out += "\nFunctions:\n";
+		std::snprintf(buff, sizeof(buff), "%12s %12s   %s\n", "self", "total", "function");
+		out += buff;
+
+		for (size_t i = 0; i < sorted.size(); ++i)
+		{
+			std::snprintf(buff, sizeof(buff), "%12zu %12zu   ", sorted[i].second.first, sorted[i].second.second);
+			out += buff + name(sorted[i].first) + "\n";
+		}
+
+		return out;
+	}
+
+	std::string Sampler::collapsed()
+	{
+		std::lock_guard<std::mutex> lock(m);
+		std::lock_guard<std::mutex> named(interning);
+		std::string out;
+
+		for (auto it = stacks.begin(); it != stacks.end(); ++it)
+		{
+			const std::vector<unsigned long long>& s = it->first;
+
+			for (size_t i = 0; i + 1 < s.size(); ++i) out += name(s[i]) + ";";
+			out += position(s.back()) + " " + std::to_string(it->second) + "\n";
+		}
+
+		return out;
+	}
+
+	bool Sampler::save(const std::string& p)
+	{
+		std::ofstream file(p, std::ios::out | std::ios::trunc);
+		if (!file.good()) return false;
+
+		file << report();
+
+		std::ofstream folded(p + ".folded", std::ios::out | std::ios::trunc);
+		if (!folded.good()) return false;
+
+		folded << collapsed();
+
+		return file.good() && folded.good();
+	}
+}
\ No newline at end of file
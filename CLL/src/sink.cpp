@@ -0,0 +1,88 @@
+#include "sink.hpp"
+
+// Author: Bartosz Niciak
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+namespace cll
+{
+	void FdSink::write(const char* s, const size_t& n)
+	{
+		size_t written = 0;
+
+		while (written < n)
+		{
+#ifdef _WIN32
+			int ret = _write(fd, s + written, (unsigned int)(n - written));
+			if (ret <= 0) return;
+#else
+			ssize_t ret = ::write(fd, s + written, n - written);
+
+			if (ret < 0 && errno == EINTR) continue;
+			if (ret <= 0) return;
+#endif
+			written += size_t(ret);
+		}
+	}
+
+	void RingSink::write(const char* s, const size_t& n)
+	{
+		if (ring.empty()) return;
+
+		// Only last bytes that fit in the ring are kept
+		size_t len = std::min(n, ring.size());
+		s += n - len;
+
+		size_t first = std::min(len, ring.size() - head);
+		std::memcpy(ring.data() + head, s, first);
+		std::memcpy(ring.data(), s + first, len - first);
+
+		head = (head + len) % ring.size();
+		count = std::min(count + len, ring.size());
+	}
+
+	std::string RingSink::str() const
+	{
+		std::string ret;
+		ret.reserve(count);
+
+		size_t start = (head + ring.size() - count) % std::max(ring.size(), size_t(1));
+
+		for (size_t i = 0; i < count; ++i) ret += ring[(start + i) % ring.size()];
+
+		return ret;
+	}
+
+	void BufferedSink::write(const char* s, const size_t& n)
+	{
+		if (buffer.length() + n > chunk)
+		{
+			if (!buffer.empty()) target->write(buffer.data(), buffer.length());
+			buffer.clear();
+
+			// Data that is bigger than a chunk is not copied into the buffer
+			if (n >= chunk)
+			{
+				target->write(s, n);
+				return;
+			}
+		}
+
+		buffer.append(s, n);
+	}
+
+	void BufferedSink::flush()
+	{
+		if (!buffer.empty()) target->write(buffer.data(), buffer.length());
+		buffer.clear();
+		target->flush();
+	}
+}
\ No newline at end of file
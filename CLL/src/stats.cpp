@@ -0,0 +1,59 @@
+#include "stats.hpp"
+
+// Author: Bartosz Niciak
+
+namespace cll
+{
+	void Stats::clear()
+	{
+		lines = 0;
+		tokens = 0;
+		reductions = 0;
+		lookups = 0;
+		misses = 0;
+		assignments = 0;
+		insertions = 0;
+		scopes = 0;
+		calls = 0;
+		memoized = 0;
+		interpreters = 0;
+		builtins = 0;
+		bytes = 0;
+	}
+
+	std::string Stats::str() const
+	{
+		std::string out;
+
+		out += "lines: " + std::to_string(lines) + "\n";
+		out += "tokens: " + std::to_string(tokens) + "\n";
+		out += "reductions: " + std::to_string(reductions) + "\n";
+		out += "lookups: " + std::to_string(lookups) + "\n";
+		out += "misses: " + std::to_string(misses) + "\n";
+		out += "assignments: " + std::to_string(assignments) + "\n";
+		out += "insertions: " + std::to_string(insertions) + "\n";
+		out += "scopes: " + std::to_string(scopes) + "\n";
+		out += "calls: " + std::to_string(calls) + "\n";
+		out += "memoized: " + std::to_string(memoized) + "\n";
+		out += "interpreters: " + std::to_string(interpreters) + "\n";
+		out += "builtins: " + std::to_string(builtins) + "\n";
+		out += "bytes: " + std::to_string(bytes) + "\n";
+
+		return out;
+	}
+
+	bool Stats::enabled()
+	{
+#ifdef CLL_STATS
+		return true;
+#else
+		return false;
+#endif
+	}
+
+	Stats*& Stats::active()
+	{
+		static thread_local Stats* stats = nullptr;
+		return stats;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include "stream.hpp"
+
+// Author: Bartosz Niciak
+
+#include <cstdlib>
+
+#ifndef _WIN32
+
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#endif
+
+namespace cll
+{
+	// READER //
+
+	Reader::Reader(const std::string& f, const size_t& siz)
+	{
+		// Buffer must be set before file is opened to take effect
+		if (siz > 0)
+		{
+			buffer.reset(new char[siz]);
+			file.rdbuf()->pubsetbuf(buffer.get(), siz);
+		}
+
+		file.open(f, std::ios::in | std::ios::binary);
+	}
+
+	bool Reader::readLine(std::string& l)
+	{
+		l.clear();
+		if (eof()) return false;
+
+		std::getline(file, l);
+		if (!l.empty() && l[l.length() - 1] == '\r') l.pop_back();
+
+		return true;
+	}
+
+	bool Reader::readChunk(std::string& c, const size_t& n)
+	{
+		c.clear();
+		if (eof()) return false;
+
+		c.resize(n);
+		file.read(&c[0], n);
+		c.resize(size_t(file.gcount()));
+
+		if (file.eof()) file.clear(std::ios::eofbit);
+
+		return !c.empty();
+	}
+
+	// WRITER //
+
+	Writer::Writer(const std::string& f, const bool& append, const size_t& siz) : capacity(siz)
+	{
+		buffer.reserve(capacity);
+
+#ifdef _WIN32
+		file = std::fopen(f.c_str(), (append) ? "ab" : "wb");
+#else
+		fd = ::open(f.c_str(), O_WRONLY | O_CREAT | ((append) ? O_APPEND : O_TRUNC), 0644);
+#endif
+	}
+
+	Writer::~Writer()
+	{
+		flush();
+
+#ifdef _WIN32
+		if (file != nullptr) std::fclose(file);
+#else
+		if (fd != -1) ::close(fd);
+#endif
+	}
+
+	bool Writer::good() const
+	{
+#ifdef _WIN32
+		return file != nullptr;
+#else
+		return fd != -1;
+#endif
+	}
+
+	bool Writer::write(const char* s, const size_t& n)
+	{
+		if (!good()) return false;
+
+		if (buffer.length() + n <= capacity)
+		{
+			buffer.append(s, n);
+			return true;
+		}
+
+		return writeAll(s, n);
+	}
+
+	bool Writer::flush()
+	{
+		if (!good()) return false;
+		return writeAll(nullptr, 0);
+	}
+
+	bool Writer::writeAll(const char* s, const size_t& n)
+	{
+		bool state = true;
+
+#ifdef _WIN32
+		if (!buffer.empty() && std::fwrite(buffer.data(), 1, buffer.length(), file) != buffer.length()) state = false;
+		if (n > 0 && std::fwrite(s, 1, n, file) != n) state = false;
+		if (std::fflush(file) != 0) state = false;
+#else
+		struct iovec vec[2] = { { const_cast<char*>(buffer.data()), buffer.length() }, { const_cast<char*>(s), n } };
+		struct iovec* it = vec;
+		int count = 2;
+
+		while (count > 0)
+		{
+			if (it->iov_len == 0)
+			{
+				++it; --count;
+				continue;
+			}
+
+			ssize_t written = ::writev(fd, it, count);
+
+			if (written < 0)
+			{
+				if (errno == EINTR) continue;
+				state = false;
+				break;
+			}
+
+			// Skips fully written parts and moves start of partially written one
+			while (count > 0 && size_t(written) >= it->iov_len)
+			{
+				written -= it->iov_len;
+				++it; --count;
+			}
+
+			if (count > 0)
+			{
+				it->iov_base = static_cast<char*>(it->iov_base) + written;
+				it->iov_len -= written;
+			}
+		}
+#endif
+
+		buffer.clear();
+		return state;
+	}
+
+	// VALUES //
+
+	// Appends one value to the array - numbers are normalized the same way as variables do it
+	static void appendValue(std::string& arr, const std::string& w, const size_t& count)
+	{
+		if (count > 0) arr += ',';
+
+		size_t digits = 0, dots = 0;
+		for (size_t i = (w[0] == '-') ? 1 : 0; i < w.length(); ++i)
+		{
+			if (w[i] >= '0' && w[i] <= '9') ++digits;
+			else if (w[i] == '.') ++dots;
+			else
+			{
+				dots = 2;
+				break;
+			}
+		}
+
+		// Integers that do not fit into 64 bits are stored as doubles
+		// The lowest integer is stored as a double too, because its absolute value does not fit either
+		bool fits = (digits > 0 && dots == 0);
+
+		if (fits)
+		{
+			bool negative = (w[0] == '-');
+			unsigned long long limit = 9223372036854775807ULL;
+			unsigned long long val = 0;
+
+			for (size_t i = negative ? 1 : 0; i < w.length() && fits; ++i)
+			{
+				unsigned long long digit = (unsigned long long)(w[i] - '0');
+
+				if (val > (limit - digit) / 10) fits = false;
+				else val = val * 10 + digit;
+			}
+
+			if (fits)
+			{
+				if (negative && val != 0) arr += '-';
+				arr += std::to_string(val);
+				return;
+			}
+		}
+
+		if (digits > 0 && dots <= 1) arr += std::to_string(std::strtod(w.c_str(), nullptr));
+		else
+		{
+			arr += '"';
+			for (size_t i = 0; i < w.length(); ++i)
+			{
+				if (w[i] == '"' || w[i] == '\\') arr += '\\';
+				arr += w[i];
+			}
+			arr += '"';
+		}
+	}
+
+	size_t readValues(std::streambuf* in, std::string& arr, const size_t& siz)
+	{
+		std::unique_ptr<char[]> buffer(new char[siz]);
+		std::string word;
+		size_t count = 0;
+
+		while (true)
+		{
+			std::streamsize n = in->sgetn(buffer.get(), std::streamsize(siz));
+
+			// Value may be split between two reads, so it is collected in 'word' until whitespace
+			for (std::streamsize i = 0; i < n; ++i)
+			{
+				char c = buffer[size_t(i)];
+
+				if (c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f')
+				{
+					if (!word.empty()) appendValue(arr, word, count++);
+					word.clear();
+				}
+				else word += c;
+			}
+
+			if (n < std::streamsize(siz)) break;
+		}
+
+		if (!word.empty()) appendValue(arr, word, count++);
+
+		return count;
+	}
+}
\ No newline at end of file
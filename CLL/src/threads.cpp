@@ -0,0 +1,150 @@
+#include "threads.hpp"
+
+// Author: Bartosz Niciak
+
+#include <algorithm>
+
+namespace cll
+{
+	// Pool and index of queue that belong to actual thread - threads that are not workers do not have them
+	static thread_local const ThreadPool* owner = nullptr;
+	static thread_local size_t worker = size_t(-1);
+
+	ThreadPool::ThreadPool(const size_t& threads) : pending(0), next(0), stopped(false)
+	{
+		for (size_t i = 0; i < threads; ++i) queues.emplace_back(new queue());
+		for (size_t i = 0; i < threads; ++i) workers.emplace_back(&ThreadPool::work, this, i);
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(m);
+			stopped = true;
+		}
+
+		cv.notify_all();
+		for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+	}
+
+	ThreadPool& ThreadPool::shared()
+	{
+		static ThreadPool pool(std::max(std::thread::hardware_concurrency(), 1u) - 1);
+		return pool;
+	}
+
+	void ThreadPool::work(const size_t& id)
+	{
+		owner = this;
+		worker = id;
+
+		while (true)
+		{
+			task t;
+
+			if (take(t, id))
+			{
+				execute(t, id);
+				continue;
+			}
+
+			std::unique_lock<std::mutex> lock(m);
+			cv.wait(lock, [this]() { return stopped || pending > 0; });
+			if (stopped) return;
+		}
+	}
+
+	void ThreadPool::push(const task& t, const size_t& id)
+	{
+		queue& q = *queues[(id < queues.size()) ? id : next++ % queues.size()];
+
+		// Counter is increased first, so that it is never lower than number of queued tasks
+		++pending;
+
+		{
+			std::lock_guard<std::mutex> lock(q.m);
+			q.tasks.push_back(t);
+		}
+
+		// Lock makes sure that worker which checks 'pending' is already waiting or sees new value
+		{
+			std::lock_guard<std::mutex> lock(m);
+		}
+
+		cv.notify_one();
+	}
+
+	bool ThreadPool::take(task& t, const size_t& id)
+	{
+		if (pending == 0) return false;
+
+		// Own queue is used as a stack - the most recent tasks are the smallest and hot in cache
+		if (id < queues.size())
+		{
+			queue& q = *queues[id];
+			std::lock_guard<std::mutex> lock(q.m);
+
+			if (!q.tasks.empty())
+			{
+				t = q.tasks.back();
+				q.tasks.pop_back();
+				--pending;
+				return true;
+			}
+		}
+
+		// Other queues are robbed from the front - the oldest tasks are the biggest
+		for (size_t i = 1; i <= queues.size(); ++i)
+		{
+			queue& q = *queues[(((id < queues.size()) ? id : 0) + i) % queues.size()];
+			std::lock_guard<std::mutex> lock(q.m);
+
+			if (!q.tasks.empty())
+			{
+				t = q.tasks.front();
+				q.tasks.pop_front();
+				--pending;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	void ThreadPool::execute(task t, const size_t& id)
+	{
+		// Second half of range is left for other workers
+		while (!queues.empty() && t.end - t.begin > t.b->grain)
+		{
+			size_t mid = t.begin + (t.end - t.begin) / 2;
+			push({ t.b, mid, t.end }, id);
+			t.end = mid;
+		}
+
+		t.b->fun(t.begin, t.end);
+
+		size_t done = t.end - t.begin;
+		if (t.b->remaining.fetch_sub(done) == done)
+		{
+			std::lock_guard<std::mutex> lock(t.b->m);
+			t.b->cv.notify_all();
+		}
+	}
+
+	void ThreadPool::run(const size_t& n, const std::function<void(size_t, size_t)>& f, const size_t& grain)
+	{
+		if (n == 0) return;
+
+		size_t id = (owner == this) ? worker : size_t(-1);
+
+		std::shared_ptr<batch> b = std::make_shared<batch>(f, n, std::max(grain, size_t(1)));
+		execute({ b, 0, n }, id);
+
+		// Calling thread helps with the rest of work until its range is done
+		task t;
+		while (b->remaining > 0 && take(t, id)) execute(t, id);
+
+		std::unique_lock<std::mutex> lock(b->m);
+		b->cv.wait(lock, [&b]() { return b->remaining == 0; });
+	}
+}
\ No newline at end of file
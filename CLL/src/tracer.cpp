@@ -0,0 +1,151 @@
+#include "tracer.hpp"
+
+// Author: Bartosz Niciak
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cll
+{
+	// Returns nanoseconds of steady clock - time of events is measured from epoch in them
+	static long long now()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	Tracer& Tracer::global()
+	{
+		static Tracer tracer;
+		return tracer;
+	}
+
+	void Tracer::owner::release()
+	{
+		if (tracer == nullptr) return;
+
+		std::lock_guard<std::mutex> lock(tracer->m);
+		tracer->free.push_back(r);
+
+		tracer = nullptr;
+		r = nullptr;
+	}
+
+	Tracer::ring* Tracer::local()
+	{
+		static thread_local owner held;
+		if (held.tracer == this) return held.r;
+
+		held.release(); // Thread records to other tracer now
+
+		std::lock_guard<std::mutex> lock(m);
+
+		if (!free.empty())
+		{
+			held.r = free.back();
+			free.pop_back();
+		}
+		else
+		{
+			rings.emplace_back(new ring(capacity, rings.size() + 1));
+			held.r = rings.back().get();
+		}
+
+		held.tracer = this;
+
+		return held.r;
+	}
+
+	void Tracer::start(const size_t& events)
+	{
+		{
+			std::lock_guard<std::mutex> lock(m);
+
+			capacity = std::max(events, size_t(1));
+			for (size_t i = 0; i < rings.size(); ++i) rings[i]->head.store(0, std::memory_order_relaxed);
+		}
+
+		// Epoch is published by enabling, threads that see tracer enabled read it after acquire
+		epoch.store(now(), std::memory_order_relaxed);
+		enabled.store(true, std::memory_order_release);
+	}
+
+	void Tracer::record(const Category& c, const char& phase, const std::string& name)
+	{
+		if (!enabled.load(std::memory_order_acquire)) return;
+
+		ring* r = local();
+		size_t head = r->head.load(std::memory_order_relaxed);
+		event& e = r->events[head % r->events.size()];
+
+		e.time = now() - epoch.load(std::memory_order_relaxed);
+		e.category = c;
+		e.phase = phase;
+
+		size_t length = std::min(name.length(), sizeof(e.name) - 1);
+		std::memcpy(e.name, name.data(), length);
+		e.name[length] = '\0';
+
+		// Event becomes visible to json() only after it is written
+		r->head.store(head + 1, std::memory_order_release);
+	}
+
+	std::string Tracer::json()
+	{
+		static const char* categories[] = { "scope", "function", "include", "script", "builtin" };
+
+		std::string out = "{\"traceEvents\":[\n";
+		bool first = true;
+		char buff[64];
+
+		std::lock_guard<std::mutex> lock(m);
+
+		for (size_t i = 0; i < rings.size(); ++i)
+		{
+			const ring& r = *rings[i];
+			size_t head = r.head.load(std::memory_order_acquire);
+			size_t count = std::min(head, r.events.size());
+
+			for (size_t ii = head - count; ii < head; ++ii)
+			{
+				const event& e = r.events[ii % r.events.size()];
+
+				if (!first) out += ",\n";
+				first = false;
+
+				out += "{\"name\":\"";
+
+				for (const char* it = e.name; *it != '\0'; ++it)
+				{
+					if (*it == '"' || *it == '\\') out += '\\';
+					if (static_cast<unsigned char>(*it) >= 0x20) out += *it;
+				}
+
+				std::snprintf(buff, sizeof(buff), "%.3f", double(e.time) / 1000);
+
+				out += "\",\"cat\":\"";
+				out += categories[static_cast<size_t>(e.category)];
+				out += "\",\"ph\":\"";
+				out += e.phase;
+				out += "\",\"ts\":";
+				out += buff;
+				out += ",\"pid\":1,\"tid\":" + std::to_string(r.thread) + "}";
+			}
+		}
+
+		out += "\n]}\n";
+
+		return out;
+	}
+
+	bool Tracer::save(const std::string& path)
+	{
+		std::ofstream file(path, std::ios::out | std::ios::trunc);
+		if (!file.good()) return false;
+
+		file << json();
+
+		return file.good();
+	}
+}
\ No newline at end of file
@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 
 namespace cll
 {
@@ -360,6 +361,39 @@ namespace cll
 		return var("");
 	}
 
+	std::vector<var> var::getElements() const
+	{
+		std::vector<var> ret;
+
+		if (type == Type::ARRAY)
+		{
+			if (value == "[]") return ret;
+
+			std::vector<var> buff = lexer(value.substr(1, value.length() - 2));
+			std::string elem("");
+
+			for (size_t i = 0; i < buff.size(); ++i)
+			{
+				if (buff[i].type == Type::SYMBOL && buff[i].value == ",")
+				{
+					ret.emplace_back(elem);
+					elem.clear();
+				}
+				else elem += buff[i].value;
+			}
+
+			ret.emplace_back(elem);
+			return ret;
+		}
+
+		size_t siz = getSize();
+		ret.reserve(siz);
+
+		for (size_t i = 0; i < siz; ++i) ret.emplace_back(getElement(i));
+
+		return ret;
+	}
+
 	std::string var::getRawString() const
 	{
 		if (type == Type::STRING || type == Type::CHAR) return value.substr(1, value.length() - 2);
@@ -0,0 +1,88 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CLL.hpp"
+
+// Runs many scripts on one thread at once - every script is executed step by step.
+// Sleeping scripts do not block the thread, they are resumed when their wake time comes.
+// Scripts that compute for a long time yield after every 50 lines, so others are not starved.
+// Every hundredth script sleeps at the bottom of deep recursion, which continues on stack segments of script.
+
+int main()
+{
+	const size_t count = 1000;
+
+	std::vector<std::unique_ptr<cll::Interpreter>> scripts;
+	std::vector<std::shared_ptr<cll::RingSink>> outputs;
+
+	for (size_t i = 0; i < count; ++i)
+	{
+		outputs.emplace_back(std::make_shared<cll::RingSink>(64));
+
+		scripts.emplace_back(std::make_unique<cll::Interpreter>());
+		scripts[i]->enableIO();
+		scripts[i]->setSink(outputs[i], 0);
+		scripts[i]->setSlice(50);
+		scripts[i]->setVar("id", std::to_string(i));
+		scripts[i]->setVar("depth", (i % 100 == 0) ? "5000" : "10");
+
+		scripts[i]->startVector(
+		{
+			"function deep",
+			"{",
+			"	if argv[0] == 0",
+			"	{",
+			"		sleep(100)",
+			"		return 0",
+			"	}",
+			"	return 1 + deep(argv[0] - 1)",
+			"}",
+			"sum = deep(depth) - depth",
+			"for n = 0, n < 3, n += 1 { sleep(100); sum += id }",
+			"for n = 0, n < 100, n += 1 { sum += 1 }",
+			"cout sum"
+		});
+	}
+
+	auto start = std::chrono::steady_clock::now();
+	size_t running = count, failed = 0;
+
+	// Simple event loop - every script is resumed when it is ready
+	while (running > 0)
+	{
+		auto now = std::chrono::steady_clock::now();
+		auto next = now + std::chrono::milliseconds(10);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!scripts[i]->isStarted()) continue;
+			if (scripts[i]->getWake() > now) 
+			{
+				if (scripts[i]->getWake() < next) next = scripts[i]->getWake();
+				continue;
+			}
+
+			cll::State state = scripts[i]->resume();
+
+			if (state == cll::State::FINISHED || state == cll::State::FAILED)
+			{
+				if (state == cll::State::FAILED || outputs[i]->str() != std::to_string(i * 3 + 100)) ++failed;
+				--running;
+			}
+		}
+
+		std::this_thread::sleep_until(next);
+	}
+
+	auto end = std::chrono::steady_clock::now();
+
+	// Every script sleeps for 400 ms, so running them one by one would take 400 seconds
+	std::cout << count << " scripts finished in " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms";
+	std::cout << ", failed: " << failed << '\n';
+
+	return (failed == 0) ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "CLL.hpp"
+#include "pool.hpp"
+
+// Runs jobs on interpreters of a pool and checks that a job does not see state left by the previous job on the same interpreter.
+// Interpreters are reset in place when they are released, so everything that a job changed has to be restored.
+
+// Script that draws numbers from generator of interpreter
+const std::vector<std::string> draw =
+{
+	"for i = 0, i < 8, i += 1 { cout rand(1000000) \" \" }"
+};
+
+// Runs script on interpreter and returns its output, or empty string if script failed
+std::string job(cll::Interpreter& interpreter, const std::vector<std::string>& script)
+{
+	std::shared_ptr<cll::RingSink> out = std::make_shared<cll::RingSink>(256);
+
+	interpreter.enableIO();
+	interpreter.setSink(out);
+
+	if (!interpreter.readVector(script)) return "";
+	interpreter.flush();
+
+	return out->str();
+}
+
+int main()
+{
+	std::vector<std::string> seeded = { "srand(1234)" };
+	seeded.insert(seeded.end(), draw.begin(), draw.end());
+
+	// Numbers that job would get if it continued sequence of seeded job
+	cll::Interpreter reference;
+	std::string first = job(reference, seeded);
+	std::string continued = job(reference, draw);
+
+	cll::Pool pool(1);
+	int wrong = 0;
+
+	// Job A seeds generator, so its numbers are reproducible
+	std::unique_ptr<cll::Interpreter> a = pool.acquire();
+	cll::Interpreter* used = a.get();
+
+	if (first.empty() || job(*a, seeded) != first) { std::cout << "Seeded sequence is not reproducible\n"; ++wrong; }
+	pool.release(std::move(a));
+
+	// Job B gets the same interpreter, but it must not continue with sequence of job A
+	std::unique_ptr<cll::Interpreter> b = pool.acquire();
+	if (b.get() != used) { std::cout << "Pool did not reuse released interpreter\n"; ++wrong; }
+
+	std::string second = job(*b, draw);
+	if (second.empty() || second == continued) { std::cout << "Job continued sequence seeded by previous job\n"; ++wrong; }
+
+	b->enableProfiling();
+	b->enableSampling();
+	job(*b, draw);
+	pool.release(std::move(b));
+
+	// Job C must not be profiled because job B was
+	std::unique_ptr<cll::Interpreter> c = pool.acquire();
+	if (c->getProfiler() != nullptr) { std::cout << "Job is profiled because previous job was\n"; ++wrong; }
+	if (c->isSampled()) { std::cout << "Job is sampled because previous job was\n"; ++wrong; }
+	pool.release(std::move(c));
+
+	std::cout << "wrong results: " << wrong << '\n';
+	return (wrong != 0) ? 1 : 0;
+}
\ No newline at end of file
@@ -0,0 +1,80 @@
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CLL.hpp"
+
+// Runs many independent interpreters on all cores at once and checks that every one of them got the right result.
+// It can be built with -fsanitize=thread to check that interpreters do not share any mutable state.
+
+// Script that uses variables, loops, user defined functions, random numbers, output and included module
+const std::vector<std::string> script =
+{
+	"include \"threads_module.cll\"",
+	"sum = 0",
+	"for i = 0, i < n, i += 1 { sum += square(i) }",
+	"r = rand(10)",
+	"if r < 0 or r > 10 { sum = -1 }",
+	"cout sum"
+};
+
+// Runs 'count' interpreters on each of 'threads' threads, returns number of wrong results
+int run(const unsigned int& threads, const unsigned int& count)
+{
+	std::atomic<int> wrong(0);
+	std::vector<std::thread> workers;
+
+	for (unsigned int t = 0; t < threads; ++t)
+	{
+		workers.emplace_back([&wrong, count, t]()
+		{
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				long long n = (t + i) % 50;
+				long long expected = (n - 1) * n * (2 * n - 1) / 6;
+
+				// Every interpreter gets its own sink, so output of threads does not interleave
+				std::shared_ptr<cll::RingSink> out = std::make_shared<cll::RingSink>(64);
+
+				std::unique_ptr<cll::Interpreter> interpreter = std::make_unique<cll::Interpreter>();
+				interpreter->enableIO();
+				interpreter->setSink(out);
+				interpreter->setVar("n", std::to_string(n));
+
+				if (!interpreter->readVector(script) || out->str() != std::to_string(expected)) ++wrong;
+			}
+		});
+	}
+
+	for (size_t i = 0; i < workers.size(); ++i) workers[i].join();
+
+	return wrong;
+}
+
+int main()
+{
+	std::ofstream module("threads_module.cll");
+	module << "function square { return argv[0] * argv[0] }\n";
+	module.close();
+
+	unsigned int cores = std::max(std::thread::hardware_concurrency(), 4u); // At least 4 threads are used to stress the library
+	const unsigned int total = 2000;
+
+	for (unsigned int threads = 1; threads <= cores; threads *= 2)
+	{
+		auto start = std::chrono::steady_clock::now();
+		int wrong = run(threads, total / threads);
+		auto end = std::chrono::steady_clock::now();
+
+		std::cout << threads << " thread(s): " << std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count() << " ms";
+		std::cout << ", wrong results: " << wrong << '\n';
+
+		if (wrong != 0) return 1;
+	}
+
+	return 0;
+}
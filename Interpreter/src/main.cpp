@@ -50,6 +50,7 @@ int main(int argc, char* argv[])
 		std::unique_ptr<cll::Interpreter> runtime = std::make_unique<cll::Interpreter>();
 		//runtime->enableDebug();
 		runtime->enableIO();
+		runtime->enableCache(); // Scripts are compiled to '.cllc' files next to them, so that next runs do not lex them again
 		
 		if (!runtime->readLine("argv = " + params.getValue())) errorLog(runtime);
 		else if (!runtime->readFile(path.getString())) errorLog(runtime);